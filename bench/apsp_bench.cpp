@@ -0,0 +1,78 @@
+// 전체 최단거리(MAP_ALL_PAIRS) 계산 방식 비교 벤치마크
+// 출발점별 다익스트라 / 블록 단위 Floyd–Warshall / 기존 재귀 loop_cost 를 그래프 크기와 밀도별로 측정한다.
+// 사용법: apsp_bench [--degree k]... [--legacy-max n] [--threads t] [노드 수...]
+//   --degree k      각 노드를 가장 가까운 k개 노드와 연결. 여러 번 주면 각각 측정 (기본 4, 16, 64)
+//                   (0 이면 완전 그래프인데, 이때 SetMap은 MAP_EUCLIDEAN으로 전환되어 테이블을 만들지 않음)
+//   --legacy-max n  기존 방식은 노드 수가 n 이하일 때만 측정 (기본 200)
+//   --threads t     두 방식 모두 같은 스레드 수로 계산 (0 이면 하드웨어 스레드 수, 기본 0)
+// max_diff는 두 방식 결과의 최대 차이 (부동소수점 덧셈 순서 차이 정도여야 함)
+// AVX2 커널로 측정하려면: make clean && make bench CXXFLAGS="-std=c++17 -O2 -pthread -mavx2"
+
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include "bench_common.h"
+#include "../src/utils/map.h"
+
+static double buildMs(Map& map, const vector<pair<int, int>>& edges, AllPairsBackend backend) {
+    map.setAllPairsBackend(backend);
+    int** arr = adjacencyMatrix(map.nodes.size(), edges);
+    BenchTimer timer;
+    map.SetMap(arr);
+    return timer.elapsedMs();
+}
+
+int main(int argc, char** argv) {
+    vector<int> degrees;
+    int legacyMax = 200;
+    int threads = 0;
+    vector<int> sizes;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--degree") == 0 && i + 1 < argc) degrees.push_back(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--legacy-max") == 0 && i + 1 < argc) legacyMax = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else sizes.push_back(atoi(argv[i]));
+    }
+    if (sizes.empty()) sizes = { 200, 1000, 2000 };
+    if (degrees.empty()) degrees = { 4, 16, 64 };
+
+    cout << "nodes\tdegree\tedges\tdijkstra_ms\tfloyd_ms\tlegacy_ms\tmax_diff" << endl;
+    for (int n : sizes) {
+        vector<Location> locations = randomLocations(n, 1000, 1000, 42);
+        for (int degree : degrees) {
+            vector<pair<int, int>> edges = nearestNeighborEdges(locations, degree);
+
+            double legacyMs = -1;
+            if (n <= legacyMax) {
+                int** legacyArr = adjacencyMatrix(n, edges);
+                legacyMs = legacyAllPairs(locations, legacyArr);
+                for (int i = 0; i < n; i++) delete[] legacyArr[i];
+                delete[] legacyArr;
+            }
+
+            Map dijkstraMap(1000, 1000), floydMap(1000, 1000);
+            vector<Location> dijkstraNodes = locations, floydNodes = locations;
+            for (Location& location : dijkstraNodes) dijkstraMap.addLocation(location);
+            for (Location& location : floydNodes) floydMap.addLocation(location);
+            dijkstraMap.setThreadCount(threads);
+            floydMap.setThreadCount(threads);
+
+            double dijkstraMs = buildMs(dijkstraMap, edges, ALL_PAIRS_DIJKSTRA);
+            double floydMs = buildMs(floydMap, edges, ALL_PAIRS_FLOYD_WARSHALL);
+
+            double maxDiff = 0;
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < n; j++) {
+                    maxDiff = max(maxDiff, fabs(dijkstraMap.GetMap_cost(i, j) - floydMap.GetMap_cost(i, j)));
+                }
+            }
+
+            cout << n << "\t" << degree << "\t" << edges.size() << "\t" << dijkstraMs << "\t" << floydMs << "\t"
+                 << (legacyMs < 0 ? string("skipped") : to_string(legacyMs)) << "\t" << maxDiff << endl;
+        }
+    }
+
+    return 0;
+}
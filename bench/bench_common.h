@@ -0,0 +1,179 @@
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <iostream>
+#include <climits>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <utility>
+#include "../src/utils/location.h"
+#include "../src/utils/map.h"
+
+using namespace std;
+
+// 벤치마크 공용 유틸리티 (시간 측정, 임의 도시 생성)
+
+class BenchTimer {
+public:
+    BenchTimer() : start(chrono::steady_clock::now()) {}
+
+    double elapsedMs() const {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+
+    void reset() { start = chrono::steady_clock::now(); }
+
+private:
+    chrono::steady_clock::time_point start;
+};
+
+// width x height 영역에 서로 다른 임의 좌표 n개 생성 (Map은 같은 좌표를 한 노드로 합치므로 중복 없이 만듦)
+inline vector<Location> randomLocations(int n, int width, int height, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> xDist(0, width - 1);
+    uniform_int_distribution<int> yDist(0, height - 1);
+
+    vector<Location> locations;
+    vector<char> used((size_t)width * height, 0);
+    locations.reserve(n);
+    while ((int)locations.size() < n) {
+        int x = xDist(rng);
+        int y = yDist(rng);
+        if (used[(size_t)y * width + x]) continue;
+        used[(size_t)y * width + x] = 1;
+        locations.push_back(Location(x, y));
+    }
+    return locations;
+}
+
+// 각 노드를 가장 가까운 degree개의 노드와 양방향으로 연결한 도로망 간선 목록
+// degree <= 0 이면 완전 그래프 (DeliverySystem::initializeMap과 동일한 연결)
+inline vector<pair<int, int>> nearestNeighborEdges(const vector<Location>& locations, int degree) {
+    int n = locations.size();
+    vector<pair<int, int>> edges;
+
+    if (degree <= 0 || degree >= n - 1) {
+        for (int u = 0; u < n; u++) {
+            for (int v = 0; v < n; v++) {
+                if (u != v) edges.push_back({ u, v });
+            }
+        }
+        return edges;
+    }
+
+    vector<pair<double, int>> candidates(n);
+    for (int u = 0; u < n; u++) {
+        for (int v = 0; v < n; v++) {
+            candidates[v] = { locations[u].calculateDistance(locations[v]), v };
+        }
+        candidates[u].first = -1;   // 자기 자신은 맨 앞으로 보내 제외
+        nth_element(candidates.begin(), candidates.begin() + degree, candidates.end());
+        for (int k = 0; k <= degree; k++) {
+            int v = candidates[k].second;
+            if (v == u) continue;
+            edges.push_back({ u, v });
+            edges.push_back({ v, u });
+        }
+    }
+    return edges;
+}
+
+// side x side 격자 도로망. 교차로 좌표를 조금씩 흔들고 일부 도로를 끊어 실제 도로처럼 만든다.
+// 도로는 양방향이며 가중치는 두 교차로 사이 직선거리
+inline vector<RoadEdge> gridRoadNetwork(int side, int spacing, unsigned seed, vector<Location>& locations) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> jitter(-spacing / 3, spacing / 3);
+    uniform_int_distribution<int> closure(0, 9);
+
+    locations.clear();
+    locations.reserve(side * side);
+    for (int r = 0; r < side; r++) {
+        for (int c = 0; c < side; c++) {
+            locations.push_back(Location(c * spacing + jitter(rng), r * spacing + jitter(rng)));
+        }
+    }
+
+    vector<RoadEdge> edges;
+    auto connect = [&](int u, int v) {
+        double weight = locations[u].calculateDistance(locations[v]);
+        edges.push_back({ u, v, weight });
+        edges.push_back({ v, u, weight });
+    };
+    for (int r = 0; r < side; r++) {
+        for (int c = 0; c < side; c++) {
+            int u = r * side + c;
+            if (c + 1 < side && (r % 4 == 0 || closure(rng) != 0)) connect(u, u + 1);       // 4줄마다 있는 간선도로는 끊지 않음
+            if (r + 1 < side && (c % 4 == 0 || closure(rng) != 0)) connect(u, u + side);
+        }
+    }
+    return edges;
+}
+
+// Map::SetMap에 넘길 n x n 연결 행렬 (SetMap이 해제함)
+inline int** adjacencyMatrix(int n, const vector<pair<int, int>>& edges) {
+    int** arr = new int*[n];
+    for (int i = 0; i < n; i++) {
+        arr[i] = new int[n];
+        fill(arr[i], arr[i] + n, 0);
+        arr[i][i] = 1;
+    }
+    for (const pair<int, int>& edge : edges) {
+        arr[edge.first][edge.second] = 1;
+    }
+    return arr;
+}
+
+// 기존 Map::loop_cost 재귀 완화 방식 (비교용으로 그대로 옮겨둠). 노드 수에 대해 지수적으로 느려지므로 작은 맵에서만 사용
+inline void legacyLoopCost(double** map_pos, int n, vector<int> check, double* temp, int node) {
+    check.push_back(node);
+
+    int* crr = new int[n];
+    for (int i = 0; i < n; i++) crr[i] = 0;
+    for (int i = 0; i < (int)check.size(); i++) crr[check.at(i)] = 1;
+
+    for (int i = 0; i < n; i++) {
+        if (crr[i] == 1 || map_pos[node][i] < 0) continue;
+
+        double cost = temp[node] + map_pos[node][i];
+        if (cost < temp[i]) {
+            temp[i] = cost;
+            legacyLoopCost(map_pos, n, check, temp, i);
+        }
+    }
+
+    delete[] crr;
+}
+
+inline double legacyAllPairs(const vector<Location>& locations, int** arr) {
+    int n = locations.size();
+    BenchTimer timer;
+
+    double** map_pos = new double*[n];
+    for (int i = 0; i < n; i++) {
+        map_pos[i] = new double[n];
+        for (int j = 0; j < n; j++) {
+            map_pos[i][j] = arr[i][j] == 1 ? locations[i].calculateDistance(locations[j]) : -1;
+        }
+    }
+
+    double** map_cost = new double*[n];
+    for (int j = 0; j < n; j++) {
+        map_cost[j] = new double[n];
+        for (int i = 0; i < n; i++) map_cost[j][i] = INT_MAX;
+        map_cost[j][j] = 0;
+        legacyLoopCost(map_pos, n, vector<int>(), map_cost[j], j);
+    }
+    double elapsed = timer.elapsedMs();
+
+    for (int i = 0; i < n; i++) {
+        delete[] map_pos[i];
+        delete[] map_cost[i];
+    }
+    delete[] map_pos;
+    delete[] map_cost;
+    return elapsed;
+}
+
+#endif
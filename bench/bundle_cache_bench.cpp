@@ -0,0 +1,125 @@
+// 배차 사이 묶음 거리 캐시 벤치마크 (DeliverySystemWithDriverCall::setBundleCacheCapacity)
+// 여러 번의 배차(틱)를 이어서 돌리며 틱마다 주문이 새로 들어오고, 배달을 마친 기사는 임의의 가게 앞으로 돌아가 기다린다.
+// 같은 노드에서 같은 주문들을 다시 보는 기사가 생기므로 캐시가 있으면 그 묶음은 다시 계산하지 않는다.
+// 사용법: bundle_cache_bench [--mode ch|road|euclid] [--drivers d] [--orders o] [--ticks t] [--limit l] [--neighbors k]
+//   --mode        맵 방식 (기본 ch: 가까운 4개 노드끼리 이은 도로망의 Contraction Hierarchy, road: 질의마다 A*, euclid: 직선거리)
+//   --drivers d   기사 수 (기본 80)
+//   --orders o    전체 주문 수 (기본 1200, 처음 10%로 시작해 틱마다 나머지를 나눠 넣음)
+//   --ticks t     배차 횟수 (기본 15)
+//   --limit l     기사 한 명이 받는 최대 주문 수 (기본 2)
+//   --neighbors k 기사마다 비교할 가까운 주문 수 (기본 8, 0이면 전체 비교 = 배차마다 거리표를 만들어 캐시는 5개 이상 묶음에만 쓰임)
+// dispatch_ms는 전체 배차 시간 합, same은 캐시 없는 배차와 배정 결과가 같은지
+
+#include <cstring>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include "bench_common.h"
+#include "../src/core/delivery_system_with_drivercall.h"
+
+struct BenchConfig {
+    MapMode mode = MAP_CONTRACTION_HIERARCHY;
+    bool euclidean = false;
+    int driverCount = 80;
+    int orderCount = 1200;
+    int ticks = 15;
+    int limit = 2;
+    int neighbors = 8;
+};
+
+class BenchSystem : public DeliverySystemWithDriverCall {
+public:
+    Map& map() { return getMap(); }
+    vector<Driver>& drivers() { return getDrivers(); }
+};
+
+struct CacheResult {
+    double ms;
+    long long hits;
+    long long misses;
+    vector<int> assignment;   // 틱마다 주문별 기사 ID
+};
+
+static CacheResult runTicks(const BenchConfig& config, size_t capacity) {
+    const int side = 10000;
+    const int storeCount = 20;
+    vector<Location> storeLocations = randomLocations(storeCount, side, side, 1);
+    vector<Location> ordererLocations = randomLocations(config.orderCount, side, side, 2);
+    mt19937 rng(3);
+
+    BenchSystem system;
+    system.setLimitOrderReceive(config.limit);
+    system.setCandidateNeighbors(config.neighbors);
+    system.setBundleCacheCapacity(capacity);
+    for (int i = 0; i < storeCount; i++) system.addStore(Store(i + 1, "store", storeLocations[i], 100));
+    for (int i = 0; i < config.orderCount; i++) system.addOrderer(Orderer(i + 1, "orderer", ordererLocations[i]));
+    for (int i = 0; i < config.driverCount; i++) system.addDriver(Driver(i + 1, "driver", storeLocations[rng() % storeCount]));
+
+    vector<unique_ptr<Order>> orders;
+    for (int i = 0; i < config.orderCount; i++) {
+        orders.emplace_back(new Order(i + 1, i + 1, rng() % storeCount + 1, ordererLocations[i]));
+        orders.back()->setDeliveryFee(3000 + (i * 37) % 2000);
+    }
+    int next = config.orderCount / 10;
+    for (int i = 0; i < next; i++) system.addOrder(*orders[i]);
+
+    if (config.euclidean) {
+        system.initializeMap();
+    }
+    else {
+        Map& map = system.map();
+        vector<RoadEdge> edges;
+        for (const pair<int, int>& edge : nearestNeighborEdges(map.nodes, 4)) {
+            double weight = map.nodes[edge.first].calculateDistance(map.nodes[edge.second]);
+            edges.push_back({ edge.first, edge.second, weight });
+            edges.push_back({ edge.second, edge.first, weight });
+        }
+        map.SetRoadMap(edges, config.mode);
+    }
+
+    CacheResult result = { 0, 0, 0, {} };
+    int perTick = (config.orderCount - next + config.ticks - 1) / config.ticks;
+    for (int tick = 0; tick < config.ticks; tick++) {
+        for (int i = 0; i < perTick && next < config.orderCount; i++) system.addOrder(*orders[next++]);
+
+        BenchTimer timer;
+        system.acceptCall();
+        result.ms += timer.elapsedMs();
+        for (const unique_ptr<Order>& order : orders) result.assignment.push_back(order->getDriverId());
+
+        //배정받은 기사 넷 중 하나는 배달을 마치고 임의의 가게 앞으로 돌아감
+        for (Driver& driver : system.drivers()) {
+            if (driver.isAvailable() || rng() % 4 != 0) continue;
+            for (int orderId : driver.getQueuedOrderIds()) driver.completeDelivery(orderId);
+            system.updateDriverLocation(driver.getId(), storeLocations[rng() % storeCount]);
+        }
+    }
+    result.hits = system.getBundleCacheHits();
+    result.misses = system.getBundleCacheMisses();
+    return result;
+}
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    string modeName = "ch";
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) modeName = argv[++i];
+        else if (strcmp(argv[i], "--drivers") == 0 && i + 1 < argc) config.driverCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--orders") == 0 && i + 1 < argc) config.orderCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) config.ticks = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--limit") == 0 && i + 1 < argc) config.limit = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--neighbors") == 0 && i + 1 < argc) config.neighbors = atoi(argv[++i]);
+    }
+    config.mode = modeName == "road" ? MAP_ROAD_GRAPH : MAP_CONTRACTION_HIERARCHY;
+    config.euclidean = modeName == "euclid";
+
+    CacheResult uncached = runTicks(config, 0);
+    CacheResult cached = runTicks(config, 1 << 18);
+
+    cout << "cache\tdispatch_ms\thits\tmisses\tsame" << endl;
+    cout << "off\t" << uncached.ms << "\t" << uncached.hits << "\t" << uncached.misses << "\t1" << endl;
+    cout << "on\t" << cached.ms << "\t" << cached.hits << "\t" << cached.misses << "\t" << (cached.assignment == uncached.assignment) << endl;
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+// Contraction Hierarchy 전처리/질의 벤치마크
+// 사용법: ch_bench [--queries q] [격자 한 변의 교차로 수...]
+//   격자 도로망(side x side 노드)에서 MAP_CONTRACTION_HIERARCHY 전처리 시간, 질의 지연, 메모리를 측정하고
+//   질의마다 A* 탐색을 하는 MAP_ROAD_GRAPH 모드와 결과/속도를 비교한다.
+
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include "bench_common.h"
+
+int main(int argc, char** argv) {
+    int queryCount = 1000;
+    vector<int> sides;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--queries") == 0 && i + 1 < argc) queryCount = atoi(argv[++i]);
+        else sides.push_back(atoi(argv[i]));
+    }
+    if (sides.empty()) sides = { 100, 320 };   // 1만, 10만 노드
+
+    cout << "nodes\tedges\tpreprocess_ms\tch_query_us\tastar_query_us\tch_memory_kb\ttable_memory_kb\tmismatches" << endl;
+    for (int side : sides) {
+        vector<Location> locations;
+        vector<RoadEdge> edges = gridRoadNetwork(side, 10, 7, locations);
+        int n = locations.size();
+
+        Map chMap(side * 10, side * 10);
+        Map roadMap(side * 10, side * 10);
+        for (Location& location : locations) {
+            chMap.addLocation(location);
+            roadMap.addLocation(location);
+        }
+
+        BenchTimer timer;
+        chMap.SetRoadMap(edges, MAP_CONTRACTION_HIERARCHY);
+        double preprocessMs = timer.elapsedMs();
+        roadMap.SetRoadMap(move(edges), MAP_ROAD_GRAPH);   //마지막 사용이므로 간선 버퍼를 넘김
+
+        mt19937 rng(11);
+        uniform_int_distribution<int> nodeDist(0, n - 1);
+        vector<pair<int, int>> queries;
+        for (int q = 0; q < queryCount; q++) queries.push_back({ nodeDist(rng), nodeDist(rng) });
+
+        vector<double> chResults;
+        timer.reset();
+        for (const pair<int, int>& query : queries) chResults.push_back(chMap.GetMap_cost(query.first, query.second));
+        double chUs = timer.elapsedMs() * 1000 / queryCount;
+
+        // A*는 느리므로 일부 질의만 측정
+        int roadCount = min(queryCount, 100);
+        int mismatches = 0;
+        timer.reset();
+        for (int q = 0; q < roadCount; q++) {
+            double expected = roadMap.GetMap_cost(queries[q].first, queries[q].second);
+            if (fabs(expected - chResults[q]) > 1e-6) mismatches++;
+        }
+        double roadUs = timer.elapsedMs() * 1000 / roadCount;
+
+        cout << n << "\t" << chMap.getEdgeCount() << "\t" << preprocessMs << "\t" << chUs << "\t" << roadUs
+             << "\t" << chMap.memoryBytes() / 1024 << "\t" << (long long)n * n * sizeof(double) / 1024 << "\t" << mismatches << endl;
+    }
+
+    return 0;
+}
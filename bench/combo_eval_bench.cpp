@@ -0,0 +1,79 @@
+// 주문 묶음 경로 평가 벤치마크 (단일 스레드)
+// 구간 거리가 미리 구해진 묶음 하나의 최단 픽업/배달 경로를 (들른 지점 집합, 마지막 지점) DP (shortestBundleRouteDP)와
+// 컴파일 시간 방문 순서 표 (shortestBundleRoute<K>)로 각각 구해 초당 평가한 묶음 수를 비교한다 (DriverCall 배차의 안쪽 루프).
+// 사용법: combo_eval_bench [--combos n] [--repeat r]
+//   --combos n   서로 다른 임의 묶음 수 (기본 4096, 묶음마다 기사 + 지점 2k개의 직선거리 구간 표)
+//   --repeat r   반복 횟수 (기본 200)
+// 단위는 초당 백만 묶음 (M/s), max_diff는 두 방식 결과의 최대 차이 (0이어야 함)
+
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include "bench_common.h"
+#include "../src/core/bundle_route.h"
+
+static const int STRIDE = 7;   // 기사 + 지점 6개 (3개 묶음까지)
+
+// 묶음마다 STRIDE x STRIDE 구간 표 하나
+static vector<double> randomLegTables(int k, int combos, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> coordinate(0, 9999);
+    vector<double> tables((size_t)combos * STRIDE * STRIDE, 0);
+    vector<Location> points(2 * k + 1);
+    for (int c = 0; c < combos; c++) {
+        for (Location& point : points) point = Location(coordinate(rng), coordinate(rng));
+        double* leg = tables.data() + (size_t)c * STRIDE * STRIDE;
+        for (int from = 0; from <= 2 * k; from++) {
+            for (int to = 0; to <= 2 * k; to++) leg[from * STRIDE + to] = points[from].calculateDistance(points[to]);
+        }
+    }
+    return tables;
+}
+
+template <int K>
+static void measure(int combos, int repeat) {
+    vector<double> tables = randomLegTables(K, combos, K);
+    vector<double> workspace;
+    vector<double> byDp(combos), byTable(combos);
+
+    BenchTimer timer;
+    for (int r = 0; r < repeat; r++) {
+        for (int c = 0; c < combos; c++) {
+            const double* leg = tables.data() + (size_t)c * STRIDE * STRIDE;
+            byDp[c] = shortestBundleRouteDP(K, [leg](int from, int to, double) { return leg[from * STRIDE + to]; }, workspace);
+        }
+    }
+    double dpMs = timer.elapsedMs();
+
+    timer.reset();
+    for (int r = 0; r < repeat; r++) {
+        for (int c = 0; c < combos; c++) {
+            byTable[c] = shortestBundleRoute<K>(tables.data() + (size_t)c * STRIDE * STRIDE, STRIDE);
+        }
+    }
+    double tableMs = timer.elapsedMs();
+
+    double maxDiff = 0;
+    for (int c = 0; c < combos; c++) maxDiff = max(maxDiff, fabs(byDp[c] - byTable[c]));
+
+    double evaluated = (double)combos * repeat;
+    cout << K << "\t" << BundleOrderings<K>::COUNT << "\t" << evaluated / (dpMs * 1000.0) << "\t" << evaluated / (tableMs * 1000.0) << "\t"
+         << dpMs / tableMs << "\t" << maxDiff << endl;
+}
+
+int main(int argc, char** argv) {
+    int combos = 4096;
+    int repeat = 200;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--combos") == 0 && i + 1 < argc) combos = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+    }
+
+    cout << "bundle\torderings\tdp_M/s\ttable_M/s\tspeedup\tmax_diff" << endl;
+    measure<1>(combos, repeat);
+    measure<2>(combos, repeat);
+    measure<3>(combos, repeat);
+
+    return 0;
+}
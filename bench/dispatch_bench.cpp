@@ -0,0 +1,82 @@
+// 배차 후보 제한 벤치마크
+// 기사/주문이 많을 때 전체 쌍 비교와 공간 색인 이웃 후보(setCandidateNeighbors)의 acceptCall 시간과 배차 품질을 비교한다.
+// 사용법: dispatch_bench [--drivers d] [--orders o] [--limit l] [--threads t] [이웃 수 k...]
+//   --drivers d   기사 수 (기본 20000)
+//   --orders o    주문 수 (기본 500, 가게 200곳에 고르게 나뉨)
+//   --limit l     기사 한 명이 받는 최대 주문 수 (기본 1)
+//   --threads t   배차 계산 스레드 수 (기본 0 = 하드웨어 스레드 수, 1이면 단일 스레드. drivercall만 해당, 결과는 같음)
+//   k 기본값은 0(전체 비교), 8, 32. 좌표는 10000 x 10000 안에서 무작위, 맵은 MAP_EUCLIDEAN
+// assigned는 배정된 주문 수, pickup_avg는 배정된 기사에서 가게까지 평균 직선거리
+
+#include <cstring>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include "bench_common.h"
+#include "../src/core/delivery_system_with_drivercall.h"
+#include "../src/core/delivery_system_with_systemselection.h"
+
+template <class System>
+static void runDispatch(const string& name, int driverCount, int orderCount, int limit, int threads, int neighbors) {
+    const int side = 10000;
+    const int storeCount = 200;
+    vector<Location> storeLocations = randomLocations(storeCount, side, side, 1);
+    vector<Location> ordererLocations = randomLocations(orderCount, side, side, 2);
+    vector<Location> driverLocations = randomLocations(driverCount, side, side, 3);
+
+    System system;
+    system.setLimitOrderReceive(limit);
+    system.setCandidateNeighbors(neighbors);
+    system.setDispatchThreads(threads);
+    for (int i = 0; i < storeCount; i++) system.addStore(Store(i + 1, "store", storeLocations[i], 100));
+    for (int i = 0; i < orderCount; i++) system.addOrderer(Orderer(i + 1, "orderer", ordererLocations[i]));
+    for (int i = 0; i < driverCount; i++) system.addDriver(Driver(i + 1, "driver", driverLocations[i]));
+
+    vector<unique_ptr<Order>> orders;
+    for (int i = 0; i < orderCount; i++) {
+        orders.emplace_back(new Order(i + 1, i + 1, i % storeCount + 1, ordererLocations[i]));
+        orders.back()->setDeliveryFee(3000 + (i * 37) % 2000);
+        system.addOrder(*orders.back());
+    }
+    system.initializeMap();
+
+    BenchTimer timer;
+    system.acceptCall();
+    double ms = timer.elapsedMs();
+
+    int assigned = 0;
+    double pickup = 0;
+    for (const unique_ptr<Order>& order : orders) {
+        if (order->getStatus() != DRIVER_CALL_ACCEPTED) continue;
+        assigned++;
+        pickup += driverLocations[order->getDriverId() - 1].calculateDistance(order->getStore()->getLocation());
+    }
+
+    cout << name << "\t" << driverCount << "\t" << orderCount << "\t" << neighbors << "\t" << ms << "\t" << assigned << "\t"
+         << (assigned > 0 ? pickup / assigned : 0) << endl;
+}
+
+int main(int argc, char** argv) {
+    int driverCount = 20000;
+    int orderCount = 500;
+    int limit = 1;
+    int threads = 0;
+    vector<int> neighborCounts;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--drivers") == 0 && i + 1 < argc) driverCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--orders") == 0 && i + 1 < argc) orderCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--limit") == 0 && i + 1 < argc) limit = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else neighborCounts.push_back(atoi(argv[i]));
+    }
+    if (neighborCounts.empty()) neighborCounts = { 0, 8, 32 };
+
+    cout << "strategy\tdrivers\torders\tneighbors\tdispatch_ms\tassigned\tpickup_avg" << endl;
+    for (int neighbors : neighborCounts) {
+        runDispatch<DeliverySystemWithDriverCall>("drivercall", driverCount, orderCount, limit, threads, neighbors);
+        runDispatch<DeliverySystemWithSystemSelection>("syssel", driverCount, orderCount, limit, threads, neighbors);
+    }
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+// MAP_ALL_PAIRS 거리 테이블 캐시 벤치마크
+// 캐시가 없을 때 (계산 + 파일 저장) 와 캐시 파일을 mmap 할 때의 SetMap 시간을 비교하고 결과가 같은지 확인한다.
+// 사용법: distance_cache_bench [--dir 폴더] [--degree k] [노드 수...]
+//   --dir 폴더   캐시 파일을 둘 폴더 (기본 /tmp). 측정이 끝나면 만든 캐시 파일은 지운다
+//   --degree k   각 노드를 가장 가까운 k개 노드와 연결 (기본 8)
+
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <sys/stat.h>
+#include "bench_common.h"
+#include "../src/utils/map.h"
+
+static double setMapMs(Map& map, const vector<pair<int, int>>& edges) {
+    int** arr = adjacencyMatrix(map.nodes.size(), edges);   //SetMap이 해제함
+    BenchTimer timer;
+    map.SetMap(arr);
+    return timer.elapsedMs();
+}
+
+int main(int argc, char** argv) {
+    string directory = "/tmp";
+    int degree = 8;
+    vector<int> sizes;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--dir") == 0 && i + 1 < argc) directory = argv[++i];
+        else if (strcmp(argv[i], "--degree") == 0 && i + 1 < argc) degree = atoi(argv[++i]);
+        else sizes.push_back(atoi(argv[i]));
+    }
+    if (sizes.empty()) sizes = { 1000, 3000, 5000 };
+
+    cout << "nodes\tedges\tcold_ms\twarm_ms\tfile_mb\tcached\tmismatches" << endl;
+    for (int n : sizes) {
+        vector<Location> locations = randomLocations(n, 1000, 1000, 42);
+        vector<pair<int, int>> edges = nearestNeighborEdges(locations, degree);
+
+        // 캐시 없이 계산해 둔 기준 맵. 같은 그래프의 캐시 파일 경로도 여기서 얻어 지워둔다
+        Map reference(1000, 1000);
+        vector<Location> referenceNodes = locations;
+        for (Location& location : referenceNodes) reference.addLocation(location);
+        setMapMs(reference, edges);
+        reference.setDistanceCacheDirectory(directory);
+        string path = reference.getDistanceCachePath();
+        remove(path.c_str());
+
+        Map cold(1000, 1000), warm(1000, 1000);
+        vector<Location> coldNodes = locations, warmNodes = locations;
+        for (Location& location : coldNodes) cold.addLocation(location);
+        for (Location& location : warmNodes) warm.addLocation(location);
+        cold.setDistanceCacheDirectory(directory);
+        warm.setDistanceCacheDirectory(directory);
+
+        double coldMs = setMapMs(cold, edges);   // 계산 후 캐시 파일 저장
+        double warmMs = setMapMs(warm, edges);   // 캐시 파일 mmap
+
+        struct stat info;
+        double fileMb = stat(path.c_str(), &info) == 0 ? info.st_size / (1024.0 * 1024.0) : 0;
+
+        int mismatches = 0;
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j += 7) {
+                if (warm.GetMap_cost(i, j) != reference.GetMap_cost(i, j)) mismatches++;
+                if (warm.find_route(warmNodes[i], warmNodes[j]).node != reference.find_route(referenceNodes[i], referenceNodes[j]).node) mismatches++;
+            }
+        }
+
+        cout << n << "\t" << edges.size() << "\t" << coldMs << "\t" << warmMs << "\t" << fileMb << "\t"
+             << (warm.isDistanceTableCached() ? "yes" : "no") << "\t" << mismatches << endl;
+        remove(path.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+// 직선거리 일괄 계산 커널 벤치마크 (단일 스레드 = 코어 하나당 처리량)
+// Location::calculateDistance를 한 쌍씩 부르는 방식과 DistanceKernel의 스칼라 / SSE2 / AVX2 커널을
+// 한 점 -> 여러 점 (SetMap 행), 여러 점 x 여러 점 (GetMap_costTable), 같은 위치끼리 (시뮬레이터 이동 루프) 로 비교한다.
+// 사용법: distance_kernel_bench [--points n] [--repeat r]
+//   --points n   점 개수 (기본 2000, 여러 점 x 여러 점은 n x n)
+//   --repeat r   반복 횟수 (기본 20)
+// 단위는 초당 백만 거리 (M/s), CPU가 지원하지 않는 커널은 건너뛴다. max_diff는 calculateDistance와의 최대 차이
+
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include "bench_common.h"
+#include "../src/utils/distance_kernel.h"
+
+struct KernelResult {
+    double oneToMany;
+    double manyToMany;
+    double pairwise;
+    double maxDiff;
+};
+
+static double throughput(long long count, double ms) {
+    return count / (ms * 1000.0);
+}
+
+static KernelResult measureLocations(const vector<Location>& sources, const vector<Location>& targets, int repeat) {
+    int n = sources.size();
+    vector<double> out((size_t)n * n);
+    KernelResult result = { 0, 0, 0, 0 };
+
+    BenchTimer timer;
+    for (int r = 0; r < repeat * n; r++) {
+        const Location& from = sources[r % n];
+        for (int j = 0; j < n; j++) out[j] = from.calculateDistance(targets[j]);
+    }
+    result.oneToMany = throughput((long long)repeat * n * n, timer.elapsedMs());
+
+    timer.reset();
+    for (int r = 0; r < repeat; r++) {
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) out[(size_t)i * n + j] = sources[i].calculateDistance(targets[j]);
+        }
+    }
+    result.manyToMany = throughput((long long)repeat * n * n, timer.elapsedMs());
+
+    timer.reset();
+    for (int r = 0; r < repeat * n; r++) {
+        for (int i = 0; i < n; i++) out[i] = sources[i].calculateDistance(targets[i]);
+    }
+    result.pairwise = throughput((long long)repeat * n * n, timer.elapsedMs());
+    return result;
+}
+
+static KernelResult measureKernel(const vector<Location>& sources, const vector<Location>& targets, int repeat) {
+    int n = sources.size();
+    PointArrays sourcePoints(sources), targetPoints(targets);
+    vector<double> out((size_t)n * n);
+    KernelResult result = { 0, 0, 0, 0 };
+
+    BenchTimer timer;
+    for (int r = 0; r < repeat * n; r++) {
+        DistanceKernel::oneToMany(sources[r % n], targetPoints, out.data());
+    }
+    result.oneToMany = throughput((long long)repeat * n * n, timer.elapsedMs());
+
+    timer.reset();
+    for (int r = 0; r < repeat; r++) {
+        DistanceKernel::manyToMany(sourcePoints, targetPoints, out.data());
+    }
+    result.manyToMany = throughput((long long)repeat * n * n, timer.elapsedMs());
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            result.maxDiff = max(result.maxDiff, fabs(out[(size_t)i * n + j] - sources[i].calculateDistance(targets[j])));
+        }
+    }
+
+    timer.reset();
+    for (int r = 0; r < repeat * n; r++) {
+        DistanceKernel::pairwise(sourcePoints, targetPoints, out.data());
+    }
+    result.pairwise = throughput((long long)repeat * n * n, timer.elapsedMs());
+    return result;
+}
+
+static void printRow(const char* name, const KernelResult& result) {
+    cout << name << "\t" << result.oneToMany << "\t" << result.manyToMany << "\t" << result.pairwise << "\t" << result.maxDiff << endl;
+}
+
+int main(int argc, char** argv) {
+    int n = 2000;
+    int repeat = 20;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--points") == 0 && i + 1 < argc) n = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+    }
+
+    vector<Location> sources = randomLocations(n, 10000, 10000, 1);
+    vector<Location> targets = randomLocations(n, 10000, 10000, 2);
+
+    cout << "supported: " << DistanceKernel::levelName(DistanceKernel::getSupportedLevel()) << endl;
+    cout << "kernel\tone_to_many_M/s\tmany_to_many_M/s\tpairwise_M/s\tmax_diff" << endl;
+    printRow("location", measureLocations(sources, targets, repeat));
+
+    DistanceKernelLevel supported = DistanceKernel::getSupportedLevel();
+    for (DistanceKernelLevel level : { DISTANCE_KERNEL_SCALAR, DISTANCE_KERNEL_SSE2, DISTANCE_KERNEL_AVX2 }) {
+        if (level > supported) continue;
+        DistanceKernel::setLevel(level);
+        printRow(DistanceKernel::levelName(level), measureKernel(sources, targets, repeat));
+    }
+    DistanceKernel::setLevel(supported);
+
+    return 0;
+}
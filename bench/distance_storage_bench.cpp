@@ -0,0 +1,89 @@
+// 거리 테이블 저장 형식별 (double / float / uint16) 메모리와 배차 조회 지연 벤치마크
+// 사용법: distance_storage_bench [--drivers d] [--orders o] [--scale s] [노드 수...]
+//   k-최근접 도로망으로 MAP_ALL_PAIRS 테이블을 만든 뒤, SystemSelection과 같은 방식으로
+//   (기사 -> 가게) + (가게 -> 주문자) 거리를 기사 x 주문 모두에 대해 조회하는 배차 한 번의 시간을 잰다.
+//   2만 노드는 double 테이블만 3.2GB이므로 메모리가 충분할 때만 지정할 것.
+
+#include <climits>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include "bench_common.h"
+
+static const char* storageName(DistanceStorage storage) {
+    switch (storage) {
+    case DISTANCE_FLOAT: return "float";
+    case DISTANCE_UINT16: return "uint16";
+    default: return "double";
+    }
+}
+
+int main(int argc, char** argv) {
+    int driverCount = 200;
+    int orderCount = 300;
+    double scale = 0.05;
+    vector<int> sizes;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--drivers") == 0 && i + 1 < argc) driverCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--orders") == 0 && i + 1 < argc) orderCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc) scale = atof(argv[++i]);
+        else sizes.push_back(atoi(argv[i]));
+    }
+    if (sizes.empty()) sizes = { 2000, 5000 };
+
+    cout << "nodes\tstorage\tbuild_ms\tmemory_mb\tdispatch_us\tmax_abs_error" << endl;
+    for (int n : sizes) {
+        vector<Location> locations = randomLocations(n, 1000, 1000, 42);
+        vector<RoadEdge> edges;
+        for (const pair<int, int>& edge : nearestNeighborEdges(locations, 8)) {
+            edges.push_back({ edge.first, edge.second, locations[edge.first].calculateDistance(locations[edge.second]) });
+        }
+
+        // 기사 위치, (가게, 주문자) 쌍을 노드 중에서 임의로 고름
+        mt19937 rng(3);
+        uniform_int_distribution<int> nodeDist(0, n - 1);
+        vector<int> driverNodes(driverCount);
+        vector<pair<int, int>> orderNodes(orderCount);
+        for (int& node : driverNodes) node = nodeDist(rng);
+        for (pair<int, int>& order : orderNodes) order = { nodeDist(rng), nodeDist(rng) };
+
+        vector<double> reference;
+        DistanceStorage storages[] = { DISTANCE_DOUBLE, DISTANCE_FLOAT, DISTANCE_UINT16 };
+        for (DistanceStorage storage : storages) {
+            Map map(1000, 1000);
+            vector<Location> copies = locations;
+            for (Location& location : copies) map.addLocation(location);
+            map.setDistanceStorage(storage, scale);
+
+            BenchTimer timer;
+            map.SetRoadMap(edges, MAP_ALL_PAIRS);
+            double buildMs = timer.elapsedMs();
+
+            int rounds = 20;
+            vector<double> costs(driverNodes.size() * orderNodes.size());
+            timer.reset();
+            for (int round = 0; round < rounds; round++) {
+                size_t k = 0;
+                for (int driver : driverNodes) {
+                    for (const pair<int, int>& order : orderNodes) {
+                        costs[k++] = map.GetMap_cost(driver, order.first) + map.GetMap_cost(order.first, order.second);
+                    }
+                }
+            }
+            double dispatchUs = timer.elapsedMs() * 1000 / rounds;
+
+            if (storage == DISTANCE_DOUBLE) reference = costs;
+            double maxError = 0;
+            for (size_t k = 0; k < costs.size(); k++) {
+                if (reference[k] >= INT_MAX) continue;
+                maxError = max(maxError, fabs(costs[k] - reference[k]));
+            }
+
+            cout << n << "\t" << storageName(storage) << "\t" << buildMs << "\t" << map.memoryBytes() / (1024.0 * 1024.0)
+                 << "\t" << dispatchUs << "\t" << maxError << endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+// 도로 소요시간 변경 벤치마크
+// Map::updateEdgeWeights로 MAP_ALL_PAIRS 테이블을 고치는 시간과, 바뀐 간선으로 SetRoadMap을 처음부터 다시 하는 시간을 비교한다.
+// 사용법: edge_update_bench [--side s] [--rounds r] [한 번에 바꿀 간선 수...]
+//   --side s     s x s 격자 도로망 (기본 60)
+//   --rounds r   배치마다 r번 반복해 평균 (기본 3)
+//   간선 수 기본값은 1, 100, 10000. 각 간선의 소요시간은 원래 값의 0.5 ~ 2배 사이로 바뀐다 (정체/해소)
+// max_diff는 고친 테이블과 다시 만든 테이블의 최대 차이
+
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include "bench_common.h"
+#include "../src/utils/map.h"
+
+int main(int argc, char** argv) {
+    int side = 60;
+    int rounds = 3;
+    vector<int> batches;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--side") == 0 && i + 1 < argc) side = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) rounds = atoi(argv[++i]);
+        else batches.push_back(atoi(argv[i]));
+    }
+    if (batches.empty()) batches = { 1, 100, 10000 };
+
+    vector<Location> locations;
+    vector<RoadEdge> baseEdges = gridRoadNetwork(side, 10, 7, locations);
+    int n = locations.size();
+
+    Map map(side * 10, side * 10);
+    for (Location& location : locations) map.addLocation(location);
+    map.SetRoadMap(baseEdges, MAP_ALL_PAIRS);
+    vector<RoadEdge> edges = baseEdges;   // map에 반영된 현재 가중치
+
+    mt19937 rng(5);
+    uniform_int_distribution<int> edgeDist(0, edges.size() - 1);
+    uniform_real_distribution<double> factorDist(0.5, 2.0);
+
+    cout << "nodes\tedges\tbatch\tupdate_ms\trebuild_ms\tmax_diff" << endl;
+    for (int batch : batches) {
+        double updateMs = 0;
+        double rebuildMs = 0;
+        double maxDiff = 0;
+
+        for (int round = 0; round < rounds; round++) {
+            vector<RoadEdge> changes;
+            for (int k = 0; k < batch; k++) {
+                int index = edgeDist(rng);
+                edges[index].weight = baseEdges[index].weight * factorDist(rng);
+                changes.push_back(edges[index]);
+            }
+
+            BenchTimer timer;
+            map.updateEdgeWeights(changes);
+            updateMs += timer.elapsedMs();
+
+            Map rebuilt(side * 10, side * 10);
+            vector<Location> rebuiltNodes = locations;
+            for (Location& location : rebuiltNodes) rebuilt.addLocation(location);
+            timer.reset();
+            rebuilt.SetRoadMap(edges, MAP_ALL_PAIRS);
+            rebuildMs += timer.elapsedMs();
+
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < n; j++) {
+                    maxDiff = max(maxDiff, fabs(map.GetMap_cost(i, j) - rebuilt.GetMap_cost(i, j)));
+                }
+            }
+        }
+
+        cout << n << "\t" << map.getEdgeCount() << "\t" << batch << "\t" << updateMs / rounds << "\t"
+             << rebuildMs / rounds << "\t" << maxDiff << endl;
+    }
+
+    return 0;
+}
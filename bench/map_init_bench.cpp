@@ -0,0 +1,60 @@
+// Map::SetMap 초기화 시간 벤치마크
+// 사용법: map_init_bench [--degree k] [--legacy-max n] [--threads t] [노드 수...]
+//   --degree k      각 노드를 가장 가까운 k개 노드와 연결 (0 이면 완전 그래프, 기본 8)
+//   --legacy-max n  기존 재귀 loop_cost 방식은 노드 수가 n 이하일 때만 측정 (기본 200, 지수적으로 느려짐)
+//   --threads t     SetMap 병렬 계산 스레드 수 (0 이면 하드웨어 스레드 수, 기본 0). 단일 스레드 시간과 함께 출력
+
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include "bench_common.h"
+#include "../src/utils/map.h"
+
+int main(int argc, char** argv) {
+    int degree = 8;
+    int legacyMax = 200;
+    int threads = 0;
+    vector<int> sizes;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--degree") == 0 && i + 1 < argc) degree = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--legacy-max") == 0 && i + 1 < argc) legacyMax = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else sizes.push_back(atoi(argv[i]));
+    }
+    if (sizes.empty()) sizes = { 1000, 5000, 10000 };
+
+    cout << "nodes\tedges\tthreads\tsetmap_ms\tsingle_thread_ms\tlegacy_ms" << endl;
+    for (int n : sizes) {
+        vector<Location> locations = randomLocations(n, 1000, 1000, 42);
+        vector<pair<int, int>> edges = nearestNeighborEdges(locations, degree);
+
+        double legacyMs = -1;
+        if (n <= legacyMax) {
+            int** legacyArr = adjacencyMatrix(n, edges);
+            legacyMs = legacyAllPairs(locations, legacyArr);
+            for (int i = 0; i < n; i++) delete[] legacyArr[i];
+            delete[] legacyArr;
+        }
+
+        Map map(1000, 1000);
+        for (Location& location : locations) map.addLocation(location);
+
+        map.setThreadCount(1);
+        int** arr = adjacencyMatrix(n, edges);   //SetMap이 arr를 해제하므로 측정마다 새로 만든다
+        BenchTimer timer;
+        map.SetMap(arr);
+        double singleMs = timer.elapsedMs();
+
+        map.setThreadCount(threads);
+        arr = adjacencyMatrix(n, edges);
+        timer.reset();
+        map.SetMap(arr);
+        double setMapMs = timer.elapsedMs();
+
+        cout << n << "\t" << edges.size() << "\t" << map.getThreadCount() << "\t" << setMapMs << "\t" << singleMs << "\t"
+             << (legacyMs < 0 ? string("skipped") : to_string(legacyMs)) << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+// 노드 번호 순서에 따른 거리 테이블 조회 국소성 벤치마크
+// MAP_ALL_PAIRS 격자 도로망에서 "서로 가까운 노드들끼리의 거리 조회" (배차 한 번에 주변 기사 x 주변 가게를 보는 패턴)를
+// 노드 번호가 뒤섞인 경우, 행 우선(입력 순서), Map::reorderNodes로 Morton / Hilbert 순서로 다시 매긴 경우에 측정한다.
+// 사용법: node_order_bench [--side s] [--cluster m] [--queries q] [--storage double|float|uint16]
+//   --side s      s x s 격자 도로망 (기본 80, 테이블이 캐시보다 훨씬 커야 차이가 드러남)
+//   --cluster m   질의 하나는 임의 중심에서 가장 가까운 m개 노드 사이의 m x m 조회 (기본 32)
+//   --queries q   질의 수 (기본 4000)
+//   --storage     거리 테이블 원소 형식 (기본 double)
+// lines_per_query는 질의 하나가 건드리는 서로 다른 64바이트 캐시 라인 수 (번호 순서만으로 정해지는 값),
+// rows_span은 질의 하나에 쓰인 노드 번호의 최대 - 최소 (작을수록 행들이 메모리에서 가까움)
+
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <unordered_set>
+#include "bench_common.h"
+#include "../src/utils/map.h"
+
+struct OrderResult {
+    double nsPerLookup;
+    double linesPerQuery;
+    double rowsSpan;
+    double checksum;
+};
+
+// clusters는 좌표로 들고 있다가 현재 번호로 바꿔서 조회 (reorderNodes 후에도 같은 질의)
+static OrderResult measure(const Map& map, const vector<vector<Location>>& clusters, int passes) {
+    size_t elementBytes = map.getDistanceStorage() == DISTANCE_DOUBLE ? 8 : map.getDistanceStorage() == DISTANCE_FLOAT ? 4 : 2;
+    vector<vector<int>> queries;
+    double lines = 0;
+    double span = 0;
+    for (const vector<Location>& cluster : clusters) {
+        vector<int> ids;
+        for (const Location& location : cluster) ids.push_back(map.findNode(location.getX(), location.getY()));
+        unordered_set<long long> touched;
+        for (int from : ids) {
+            for (int to : ids) touched.insert((long long)from * 1000000 + (long long)to * elementBytes / 64);
+        }
+        lines += touched.size();
+        span += *max_element(ids.begin(), ids.end()) - *min_element(ids.begin(), ids.end());
+        queries.push_back(ids);
+    }
+
+    double sum = 0;
+    long long lookups = 0;
+    BenchTimer timer;
+    for (int pass = 0; pass < passes; pass++) {
+        for (const vector<int>& ids : queries) {
+            for (int from : ids) {
+                for (int to : ids) sum += map.GetMap_cost(from, to);
+            }
+            lookups += (long long)ids.size() * ids.size();
+        }
+    }
+    double ms = timer.elapsedMs();
+    return { ms * 1e6 / lookups, lines / clusters.size(), span / clusters.size(), sum / passes };
+}
+
+static void printRow(const string& name, int n, double reorderMs, const OrderResult& result) {
+    cout << name << "\t" << n << "\t" << reorderMs << "\t" << result.nsPerLookup << "\t" << result.linesPerQuery << "\t"
+         << result.rowsSpan << "\t" << (long long)result.checksum << endl;
+}
+
+int main(int argc, char** argv) {
+    int side = 80;
+    int clusterSize = 32;
+    int queryCount = 4000;
+    DistanceStorage storage = DISTANCE_DOUBLE;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--side") == 0 && i + 1 < argc) side = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--cluster") == 0 && i + 1 < argc) clusterSize = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--queries") == 0 && i + 1 < argc) queryCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--storage") == 0 && i + 1 < argc) {
+            string name = argv[++i];
+            storage = name == "float" ? DISTANCE_FLOAT : name == "uint16" ? DISTANCE_UINT16 : DISTANCE_DOUBLE;
+        }
+    }
+
+    vector<Location> locations;
+    vector<RoadEdge> edges = gridRoadNetwork(side, 10, 7, locations);
+    int n = locations.size();
+    clusterSize = min(clusterSize, n);
+
+    mt19937 rng(11);
+    vector<vector<Location>> clusters;
+    uniform_int_distribution<int> centerDist(0, n - 1);
+    vector<pair<double, int>> byDistance(n);
+    for (int q = 0; q < queryCount; q++) {
+        const Location& center = locations[centerDist(rng)];
+        for (int u = 0; u < n; u++) byDistance[u] = { center.calculateDistance(locations[u]), u };
+        partial_sort(byDistance.begin(), byDistance.begin() + clusterSize, byDistance.end());
+        vector<Location> cluster;
+        for (int k = 0; k < clusterSize; k++) cluster.push_back(locations[byDistance[k].second]);
+        shuffle(cluster.begin(), cluster.end(), rng);
+        clusters.push_back(cluster);
+    }
+    int passes = max(1, 20000000 / (queryCount * clusterSize * clusterSize));
+
+    cout << "order\tnodes\treorder_ms\tns_per_lookup\tlines_per_query\trows_span\tchecksum" << endl;
+    {
+        Map map(side * 10, side * 10);
+        vector<Location> rowMajor = locations;
+        for (Location& location : rowMajor) map.addLocation(location);
+        map.setDistanceStorage(storage);
+        map.SetRoadMap(edges, MAP_ALL_PAIRS);
+        printRow("row_major", n, 0, measure(map, clusters, passes));
+    }
+
+    // 노드 번호가 좌표와 무관하게 매겨진 경우 (주문자/가게/기사가 등록되는 순서대로 번호가 붙는 실제 상황)
+    vector<int> shuffled(n);
+    for (int u = 0; u < n; u++) shuffled[u] = u;
+    shuffle(shuffled.begin(), shuffled.end(), rng);
+    vector<int> position(n);
+    vector<Location> shuffledLocations(n);
+    for (int i = 0; i < n; i++) {
+        position[shuffled[i]] = i;
+        shuffledLocations[i] = locations[shuffled[i]];
+    }
+    for (RoadEdge& edge : edges) {
+        edge.from = position[edge.from];
+        edge.to = position[edge.to];
+    }
+
+    Map map(side * 10, side * 10);
+    for (Location& location : shuffledLocations) map.addLocation(location);
+    map.setDistanceStorage(storage);
+    map.SetRoadMap(edges, MAP_ALL_PAIRS);
+    printRow("shuffled", n, 0, measure(map, clusters, passes));
+
+    BenchTimer timer;
+    map.reorderNodes(NODE_ORDER_MORTON);
+    double reorderMs = timer.elapsedMs();
+    printRow("morton", n, reorderMs, measure(map, clusters, passes));
+
+    timer.reset();
+    map.reorderNodes(NODE_ORDER_HILBERT);
+    reorderMs = timer.elapsedMs();
+    printRow("hilbert", n, reorderMs, measure(map, clusters, passes));
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+#ifndef BUNDLE_ROUTE_H
+#define BUNDLE_ROUTE_H
+
+#include <array>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+
+using namespace std;
+
+// 주문 k개 묶음의 최단 픽업/배달 경로 길이 계산.
+// 지점 s (< k)는 s번 주문의 가게, k + s는 그 주문의 주문자이고 주문자는 가게를 들른 뒤에만 갈 수 있다.
+// 구간 번호는 0번이 기사 위치, 1 + s번이 지점 s.
+// shortestBundleRoute<K>는 가능한 방문 순서를 컴파일 시간에 표로 만들어 펼친 덧셈으로 계산하고 (K <= 3 용),
+// shortestBundleRouteDP는 (들른 지점 집합, 마지막 지점) DP로 임의의 k와 출발 시각에 따라 바뀌는 구간 거리를 처리한다.
+// 둘 다 경로를 기사 쪽부터 차례로 더하므로 같은 구간 거리면 결과가 비트 단위로 같다.
+
+constexpr int bundleOrderingCount(int k) {   // (2k)! / 2^k
+    int count = 1;
+    for (int i = 1; i <= 2 * k; i++) count *= i;
+    return count >> k;
+}
+
+// K개 주문 묶음에서 가게가 주문자보다 먼저 오는 방문 순서 전부 (K=1: 1, K=2: 6, K=3: 90가지), 사전순
+template <int K>
+struct BundleOrderings {
+    static constexpr int STOPS = 2 * K;
+    static constexpr int COUNT = bundleOrderingCount(K);
+    typedef array<int, STOPS> Sequence;
+
+    static constexpr bool nextPermutation(Sequence& stops) {
+        int i = STOPS - 2;
+        while (i >= 0 && stops[i] >= stops[i + 1]) i--;
+        if (i < 0) return false;
+        int j = STOPS - 1;
+        while (stops[j] <= stops[i]) j--;
+        int swapped = stops[i];
+        stops[i] = stops[j];
+        stops[j] = swapped;
+        for (int a = i + 1, b = STOPS - 1; a < b; a++, b--) {
+            swapped = stops[a];
+            stops[a] = stops[b];
+            stops[b] = swapped;
+        }
+        return true;
+    }
+
+    static constexpr bool feasible(const Sequence& stops) {
+        bool picked[K] = {};
+        for (int stop : stops) {
+            if (stop < K) picked[stop] = true;
+            else if (!picked[stop - K]) return false;
+        }
+        return true;
+    }
+
+    static constexpr array<Sequence, COUNT> build() {
+        array<Sequence, COUNT> sequences{};
+        Sequence stops{};
+        for (int s = 0; s < STOPS; s++) stops[s] = s;
+        int count = 0;
+        do {
+            if (feasible(stops)) sequences[count++] = stops;
+        } while (nextPermutation(stops));
+        return sequences;
+    }
+
+    static constexpr array<Sequence, COUNT> sequences = build();
+};
+
+// I번 방문 순서의 길이. 순서가 상수이므로 구간 거리 읽기는 모두 고정 위치이고 덧셈은 펼쳐진다
+template <int K, size_t I, size_t... S>
+inline double bundleSequenceLength(const double* leg, int stride, index_sequence<S...>) {
+    constexpr typename BundleOrderings<K>::Sequence sequence = BundleOrderings<K>::sequences[I];
+    return (leg[1 + sequence[0]] + ... + leg[(1 + sequence[S]) * stride + 1 + sequence[S + 1]]);
+}
+
+template <int K, size_t... I>
+inline double shortestOverOrderings(const double* leg, int stride, index_sequence<I...>) {
+    double best = numeric_limits<double>::max();
+    ((best = min(best, bundleSequenceLength<K, I>(leg, stride, make_index_sequence<2 * K - 1>()))), ...);
+    return best;
+}
+
+// leg[from * stride + to] : 구간 거리 (출발 시각과 무관해야 함)
+template <int K>
+inline double shortestBundleRoute(const double* leg, int stride) {
+    return shortestOverOrderings<K>(leg, stride, make_index_sequence<BundleOrderings<K>::COUNT>());
+}
+
+// leg(from, to, elapsed) : 기사 출발 후 elapsed만큼 지나 from을 떠날 때 to까지의 구간 거리.
+// 늦게 출발해 먼저 도착하는 일은 없으므로(FIFO) 상태마다 가장 이른 도착만 남기면 정확하다. workspace는 늘어나기만 하는 재사용 버퍼
+template <typename Leg>
+double shortestBundleRouteDP(int k, Leg leg, vector<double>& workspace) {
+    const double UNVISITED = numeric_limits<double>::max();
+    if (k == 0) return 0;
+
+    int stops = 2 * k;
+    int full = (1 << stops) - 1;
+    int pickupMask = (1 << k) - 1;
+    size_t stateCount = (size_t)(full + 1) * stops;
+    if (workspace.size() < stateCount) workspace.resize(stateCount);
+    fill(workspace.begin(), workspace.begin() + stateCount, UNVISITED);
+    for (int i = 0; i < k; i++) {
+        workspace[(size_t)(1 << i) * stops + i] = leg(0, 1 + i, 0.0);
+    }
+
+    for (int mask = 1; mask < full; mask++) {
+        int picked = mask & pickupMask;
+        if ((mask >> k) & ~picked) continue;   //가게보다 주문자를 먼저 들른 집합
+        const double* cost = workspace.data() + (size_t)mask * stops;
+        for (int last = 0; last < stops; last++) {
+            double elapsed = cost[last];
+            if (elapsed == UNVISITED) continue;
+            for (int next = 0; next < stops; next++) {
+                if (mask & (1 << next)) continue;
+                if (next >= k && !(picked & (1 << (next - k)))) continue;
+
+                double arrival = elapsed + leg(1 + last, 1 + next, elapsed);
+                double& best = workspace[(size_t)(mask | (1 << next)) * stops + next];
+                if (arrival < best) best = arrival;
+            }
+        }
+    }
+
+    double bestDist = UNVISITED;
+    for (int last = k; last < stops; last++) {   //마지막 지점은 항상 어떤 주문의 주문자
+        bestDist = min(bestDist, workspace[(size_t)full * stops + last]);
+    }
+    return bestDist;
+}
+
+#endif
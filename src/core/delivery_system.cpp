@@ -33,6 +33,29 @@ void DeliverySystem::addDriver(const Driver& driver) {
     map.addLocation(loc);
     drivers.back().setLocationNode(loc.node);
     map.addItem(MapItem(drivers.back().getCurrentLocation(), DRIVER, driver.getId()));
+    driverIndex.insert(drivers.size() - 1, loc.getX(), loc.getY());
+}
+
+void DeliverySystem::updateDriverLocation(int driverId, const Location& location) {
+    auto driverIt = find_if(drivers.begin(), drivers.end(), [&](const Driver& driver) {
+        return driver.getId() == driverId;
+        });
+    if (driverIt == drivers.end()) {
+        cerr << "Error: Driver with ID " << driverId << " not found." << endl;
+        return;
+    }
+
+    //도로 그래프/CH에서 새로 만든 노드는 간선이 없어 모든 거리가 INT_MAX가 되므로 이미 있는 노드로만 이동
+    //(직선거리 맵이나 초기화 전에는 노드를 추가해도 바로 쓸 수 있음)
+    Location loc = location;
+    if (map.isInitialized() && map.getMode() != MAP_EUCLIDEAN && map.findNode(loc.getX(), loc.getY()) < 0) {
+        cerr << "Error: Location (" << loc.getX() << ", " << loc.getY() << ") is not a node of the road map." << endl;
+        return;
+    }
+    map.addLocation(loc);
+    driverIt->updateLocation(loc);
+    map.moveItem(DRIVER, driverId, driverIt->getCurrentLocation());
+    driverIndex.insert(driverIt - drivers.begin(), loc.getX(), loc.getY());
 }
 
 void DeliverySystem::addOrder(const Order& order) {
@@ -65,6 +88,28 @@ void DeliverySystem::addOrder(const Order& order) {
     }
 
     orders.push_back(orderPtr);
+    orderById[orderPtr->getOrderId()] = orderPtr;
+    if (orderPtr->getStatus() == ORDER_ACCEPTED && orderPtr->getStore() != nullptr) {
+        const Location& storeLoc = orderPtr->getStore()->getLocation();
+        orderIndex.insert(orderPtr->getOrderId(), storeLoc.getX(), storeLoc.getY());
+    }
+}
+
+vector<Order*> DeliverySystem::nearestOpenOrders(const Location& location, int k) const {
+    vector<Order*> result;
+    vector<int> ids = orderIndex.kNearest(location.getX(), location.getY(), k, [&](int orderId) {
+        return orderById.at(orderId)->getStatus() == ORDER_ACCEPTED;   //색인 밖에서 상태가 바뀐 주문은 건너뜀
+        });
+    for (int orderId : ids) {
+        result.push_back(orderById.at(orderId));
+    }
+    return result;
+}
+
+vector<int> DeliverySystem::nearestAvailableDrivers(const Location& location, int k) const {
+    return driverIndex.kNearest(location.getX(), location.getY(), k, [&](int index) {
+        return drivers[index].isAvailable();
+        });
 }
 /*
 void DeliverySystem::requestCallsToDrivers() {
@@ -87,6 +132,7 @@ bool DeliverySystem::assignOrderToDriver(Order* order, Driver& driver) {
 
     order->assignDriver(driver.getId());
     driver.addOrder(order);
+    orderIndex.remove(order->getOrderId());
     return true;
 }
 
@@ -136,14 +182,28 @@ void DeliverySystem::initializeMap() {
         return;
     }
     
-    int** arr = new int*[nodeCount];
-    for (int i = 0; i < nodeCount; i++) {
-        arr[i] = new int[nodeCount];
-        for (int j = 0; j < nodeCount; j++) {
-            arr[i][j] = 1;
-        }
+    // 모든 노드가 서로 직선으로 연결되므로 NxN 연결 행렬 대신 유클리드 모드로 설정
+    map.SetEuclideanMap();
+}
+
+void DeliverySystem::reorderNodes(NodeOrder order) {
+    vector<int> newId = map.reorderNodes(order);
+    auto remap = [&](int node) {
+        return node >= 0 && node < (int)newId.size() ? newId[node] : node;
+    };
+
+    for (Orderer& orderer : orderers) {
+        orderer.setLocationNode(remap(orderer.getLocation().node));
+    }
+    for (Store& store : stores) {
+        store.setLocationNode(remap(store.getLocation().node));
+    }
+    for (Driver& driver : drivers) {
+        driver.setLocationNode(remap(driver.getCurrentLocation().node));
+    }
+    for (Order* order : orders) {   //가게/주문자 포인터는 위 벡터를 가리키므로 배달지만 바꾸면 됨
+        order->setDeliveryLocationNode(remap(order->getDeliveryLocation().node));
     }
-    map.SetMap(arr);
 }
 
 void DeliverySystem::statusUpdate() {                                                // 주문 상태 점검용 메서드
@@ -183,6 +243,6 @@ void DeliverySystem::statusUpdate() {
 
 void DeliverySystem::setLimitOrderReceive(int limit) {
     if (limit < 1) limit = 1;
-	else if (limit > 3) limit = 3;
+	else if (limit > MAX_LIMIT_ORDER_RECEIVE) limit = MAX_LIMIT_ORDER_RECEIVE;
     limitOrderReceive = limit;
 }
\ No newline at end of file
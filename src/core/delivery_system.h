@@ -3,7 +3,9 @@
 
 #include <iostream>
 #include <vector>
+#include <unordered_map>
 #include "../utils/map.h"
+#include "../utils/spatial_grid.h"
 #include "../entities/orderer.h"
 #include "../entities/driver.h"
 #include "../entities/store.h"
@@ -13,6 +15,8 @@ using namespace std;
 
 class DeliverySystem {
 public:
+    static constexpr int MAX_LIMIT_ORDER_RECEIVE = 6;   //묶음 경로 DP가 3^k 상태를 보므로 이 정도까지만 허용
+
     DeliverySystem();
     virtual ~DeliverySystem();
 
@@ -21,6 +25,7 @@ public:
     void addStore(const Store& store);
     void addDriver(const Driver& driver);
     void addOrder(const Order& order);
+    void updateDriverLocation(int driverId, const Location& location);   // 기사 위치 이동 (맵 노드, DRIVER 아이템, 공간 색인도 같이 갱신). 초기화된 도로 맵에 없는 좌표면 거부
 
     // 배차 및 주문 처리 단계의 메서드들
 	// void requestCallsToDrivers();   // 현재 orders 내에 있는 모든 주문들을 drivers에게 배차 요청 (driver의 배차 큐에 추가)
@@ -35,8 +40,19 @@ public:
     // 시뮬레이터를 위한 조회 메서드
     vector<Order*>& getAllOrders() { return orders; }
     void initializeMap();
-	void setLimitOrderReceive(int limit);   //driver가 한번에 받을수있는 최대 주문수 설정(최솟값 1,최댓값 3)
+	//맵 노드 번호를 공간 채움 곡선 순서로 다시 매기고 주문자/가게/기사/주문이 들고 있는 번호도 바꿈 (initializeMap 이후, 배차 전에 호출)
+	void reorderNodes(NodeOrder order = NODE_ORDER_HILBERT);
+	void setLimitOrderReceive(int limit);   //driver가 한번에 받을수있는 최대 주문수 설정(최솟값 1,최댓값 MAX_LIMIT_ORDER_RECEIVE)
 	int getLimitOrderReceive() const { return limitOrderReceive; }  //driver가 한번에 받을수있는 최대 주문수 반환
+	void setCurrentTime(double time) { currentTime = time; }   //배차 시각 (시간대별 소요시간 프로필이 있을 때 거리 계산에 사용)
+	double getCurrentTime() const { return currentTime; }
+	//배차할 때 기사마다 가까운 k개 주문(가게 위치 기준)만 후보로 비교 (0이면 전체 비교, 기본값).
+	//기사/주문이 많을 때 전체 쌍 대신 공간 색인의 이웃만 보므로 결과는 전체 비교와 다를 수 있음
+	void setCandidateNeighbors(int k) { candidateNeighbors = k > 0 ? k : 0; }
+	int getCandidateNeighbors() const { return candidateNeighbors; }
+	//배차 계산에 쓸 스레드 수 (0이면 하드웨어 스레드 수, 1이면 단일 스레드). 스레드 수와 관계없이 배차 결과는 같다
+	void setDispatchThreads(int threads) { dispatchThreads = threads > 0 ? threads : 0; }
+	int getDispatchThreads() const { return dispatchThreads; }
 
 protected:
 	// getters
@@ -45,6 +61,9 @@ protected:
     vector<Driver>& getDrivers() { return drivers; }
     vector<Store>& getStores() { return stores; }
 	vector<Order*>& getOrders() { return orders; }
+	// 공간 색인 질의
+	vector<Order*> nearestOpenOrders(const Location& location, int k) const;   // 아직 배차 안 된(ORDER_ACCEPTED) 주문 중 가게가 가까운 순서로 k개
+	vector<int> nearestAvailableDrivers(const Location& location, int k) const;   // 배차 가능한 기사 중 가까운 순서로 k명 (drivers 벡터의 인덱스)
 
 private:
     Map map;
@@ -53,6 +72,12 @@ private:
     vector<Store> stores;
     vector<Order*> orders;
 	int limitOrderReceive = 1; //driver가 한번에 받을수있는 최대 주문수(기본값 1)
+	double currentTime = 0;   //현재 배차 시각
+	int candidateNeighbors = 0;
+	int dispatchThreads = 0;
+	SpatialGrid driverIndex;   // drivers 벡터 인덱스 -> 기사 위치
+	SpatialGrid orderIndex;    // 주문 ID -> 가게 위치 (ORDER_ACCEPTED인 동안만)
+	unordered_map<int, Order*> orderById;
 };
 
 
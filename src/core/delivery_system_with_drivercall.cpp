@@ -3,82 +3,175 @@
 #include <vector>
 #include <utility>
 #include <algorithm>
-#include <numeric>
 #include <limits>
+#include <unordered_set>
 #include "delivery_system_with_drivercall.h"
+#include "bundle_route.h"
 
 using namespace std;
 
-DeliverySystemWithDriverCall::DeliverySystemWithDriverCall() : DeliverySystem() {}
+DeliverySystemWithDriverCall::DeliverySystemWithDriverCall() : DeliverySystem(), workerStates(1) {}
 
 DeliverySystemWithDriverCall::~DeliverySystemWithDriverCall() = default;
 
-vector<vector<Order*>> DeliverySystemWithDriverCall::generateOrderCombos(const vector<Order*>& availableOrders, int maxComboSize) {
-    vector<vector<Order*>> combos;
-    int n = availableOrders.size();
-    int maxSize = min(maxComboSize, n);
-    
-    for (int size = 1; size <= maxSize; ++size) {
-        vector<int> indices(size);
-        iota(indices.begin(), indices.end(), 0);
-        
-        while (true) {
-            vector<Order*> combo;
-            combo.reserve(size);
-            for (int idx : indices) combo.push_back(availableOrders[idx]);
-            combos.push_back(combo);
-
-            int i = size - 1;
-            while (i >= 0 && indices[i] == i + n - size) --i;
-            if (i < 0) break;
-            ++indices[i];
-            for (int j = i + 1; j < size; ++j) indices[j] = indices[j - 1] + 1;
+namespace {
+
+// 주문 묶음을 목록으로 만들지 않고 하나씩 방문하는 열거기.
+// 크기 1부터 maxSize까지, 같은 크기 안에서는 인덱스 사전순으로 방문한다 (효율이 같으면 먼저 나온 묶음이 남으므로 순서가 결과에 영향).
+// 접두사 (i1 < ... < id)에 남은 자리 수만큼 뒤쪽에서 배달비가 가장 큰 주문들을 더한 값을 배달비 상한으로,
+// 접두사 주문들의 거리 하한 중 최댓값을 거리 하한으로 보고, 그 비율이 현재 최고 효율 이하면 그 접두사 아래를 모두 건너뜀.
+// 크기 3 이상에서는 접두사 안 두 주문 묶음의 최단 거리(pairBound)도 하한으로 쓴다 (큰 묶음 경로에서 나머지 지점을 빼면 두 주문 경로가 되므로)
+class ComboEnumerator {
+public:
+    ComboEnumerator(const vector<double>& fees, const vector<double>& bounds, int maxSize)
+        : fees(fees), bounds(bounds), orderCount(fees.size()), maxSize(min(maxSize, (int)fees.size())), indices(this->maxSize) {
+        //topFees[r * (n + 1) + i] : i번 이후 주문 중 배달비가 큰 r개의 합
+        topFees.assign((size_t)(this->maxSize + 1) * (orderCount + 1), 0);
+        vector<double> largest;
+        for (int i = orderCount - 1; i >= 0; i--) {
+            largest.insert(upper_bound(largest.begin(), largest.end(), fees[i], greater<double>()), fees[i]);
+            if ((int)largest.size() > this->maxSize) largest.pop_back();
+            double sum = 0;
+            for (int r = 1; r <= this->maxSize; r++) {
+                if (r <= (int)largest.size()) sum += largest[r - 1];
+                topFees[(size_t)r * (orderCount + 1) + i] = sum;
+            }
         }
     }
-    return combos;
-}
 
-double DeliverySystemWithDriverCall::bestDistanceForOrderCombo(const vector<Order*>& orderCombo, const Driver& driver, const Map& map) {
-    struct Node {
-        int orderId;
-        bool isPickup;
-        int node;
-        bool operator<(const Node& other) const {
-            if (orderId != other.orderId) return orderId < other.orderId;
-            return (isPickup && !other.isPickup);
+    // visit(indices, size)가 묶음 하나를 평가해 bestEfficiency를 갱신함. pairBound(i, j)는 i, j 두 주문 묶음의 거리 하한
+    template <typename Visit, typename PairBound>
+    void run(const double& bestEfficiency, Visit visit, PairBound pairBound) {
+        for (int size = 1; size <= maxSize; size++) {
+            extend(size, 0, 0, 0, 0, bestEfficiency, visit, pairBound);
         }
-    };
-
-    vector<Node> nodes;
-    for (Order* order : orderCombo) {
-        nodes.push_back({ order->getOrderId(), true,  order->getStore()->getLocation().getNode() });
-        nodes.push_back({ order->getOrderId(), false, order->getOrderer()->getLocation().getNode() });
     }
 
-    sort(nodes.begin(), nodes.end());
+private:
+    const vector<double>& fees;
+    const vector<double>& bounds;
+    int orderCount;
+    int maxSize;
+    vector<int> indices;
+    vector<double> topFees;
+
+    static bool cannotImprove(double feeLimit, double bound, double bestEfficiency) {
+        return feeLimit >= 0 && bound > 0 && feeLimit / bound <= bestEfficiency;
+    }
 
-    double bestDist = numeric_limits<double>::max();
+    template <typename Visit, typename PairBound>
+    void extend(int size, int depth, int start, double fee, double bound, const double& bestEfficiency, Visit& visit, PairBound& pairBound) {
+        int remaining = size - depth - 1;
+        for (int i = start; i < orderCount - remaining; i++) {
+            double comboFee = fee + fees[i];
+            double comboBound = max(bound, bounds[i]);
+            double feeLimit = comboFee + topFees[(size_t)remaining * (orderCount + 1) + i + 1];
+            if (cannotImprove(feeLimit, comboBound, bestEfficiency)) continue;
+            if (size >= 3 && depth > 0) {   //싼 하한으로 못 거른 접두사만 두 주문 묶음 거리로 다시 확인
+                for (int k = 0; k < depth; k++) {
+                    comboBound = max(comboBound, pairBound(indices[k], i));
+                }
+                if (cannotImprove(feeLimit, comboBound, bestEfficiency)) continue;
+            }
 
-    do {
-        bool valid = true;
-        set<int> picked;
-        for (auto& n : nodes) {
-            if (n.isPickup) picked.insert(n.orderId);
-            else if (!picked.count(n.orderId)) { valid = false; break; }
+            indices[depth] = i;
+            if (remaining == 0) visit(indices.data(), size);
+            else extend(size, depth + 1, i + 1, comboFee, comboBound, bestEfficiency, visit, pairBound);
         }
-        if (!valid) continue;
+    }
+};
+
+}
+
+vector<Order*> DeliverySystemWithDriverCall::bestOrderCombo(const vector<Order*>& availableOrders, const Driver& driver, const Map& map, int maxComboSize) {
+    vector<vector<Order*>> ranked = rankedOrderCombos(availableOrders, driver, map, maxComboSize, 1);
+    return ranked.empty() ? vector<Order*>() : ranked[0];
+}
+
+vector<vector<Order*>> DeliverySystemWithDriverCall::rankedOrderCombos(const vector<Order*>& availableOrders, const Driver& driver, const Map& map, int maxComboSize, int count, int worker) {
+    //어떤 묶음이든 경로는 각 주문의 기사 -> 가게 -> 주문자 순서를 포함하므로, 묶음 거리의 하한은 주문별 하한의 최댓값
+    int orderCount = availableOrders.size();
+    vector<double> fees(orderCount), bounds(orderCount);
+    for (int i = 0; i < orderCount; i++) {
+        fees[i] = availableOrders[i]->getDeliveryFee();
+        bounds[i] = distanceLowerBound(availableOrders[i], driver, map);
+    }
+
+    vector<pair<double, vector<Order*>>> ranked;   //(효율, 묶음) 효율 내림차순, 같으면 먼저 나온 묶음이 앞
+    double threshold = -1.0;   //순위에 들려면 넘어야 하는 효율 (count개가 차면 마지막 묶음의 효율)
+    vector<Order*> group;
+    vector<double> pairDistance;   //두 주문 묶음의 최단 거리, 필요할 때 계산 (음수 = 아직 모름)
+    if (maxComboSize >= 3) pairDistance.assign((size_t)orderCount * orderCount, -1);
 
-        double distSum = 0;
-        int cur = driver.getCurrentLocation().getNode();
-        for (auto& n : nodes) {
-            distSum += map.GetMap_cost(cur, n.node);
-            cur = n.node;
+    ComboEnumerator enumerator(fees, bounds, maxComboSize);
+    enumerator.run(threshold, [&](const int* indices, int size) {
+        group.clear();
+        for (int k = 0; k < size; k++) group.push_back(availableOrders[indices[k]]);
+
+        double bestDist = bundleDistance(group, driver, map, worker);
+        double efficiency = computeEfficiency(group, bestDist);
+        if (efficiency > threshold) {
+            auto position = upper_bound(ranked.begin(), ranked.end(), efficiency, [](double value, const pair<double, vector<Order*>>& entry) {
+                return value > entry.first;
+            });
+            ranked.insert(position, { efficiency, group });
+            if ((int)ranked.size() > count) ranked.pop_back();
+            if ((int)ranked.size() == count) threshold = ranked.back().first;
+        }
+    }, [&](int i, int j) {
+        double& distance = pairDistance[(size_t)i * orderCount + j];
+        if (distance < 0) {
+            distance = bundleDistance({ availableOrders[i], availableOrders[j] }, driver, map, worker);
         }
-        bestDist = min(bestDist, distSum);
+        return distance;
+    });
+
+    vector<vector<Order*>> bundles;
+    for (pair<double, vector<Order*>>& entry : ranked) {
+        bundles.push_back(move(entry.second));
+    }
+    return bundles;
+}
 
-    } while (next_permutation(nodes.begin(), nodes.end()));
+//주문 묶음의 최단 픽업/배달 경로 (bundle_route.h). 구간 거리가 시간에 따라 바뀌지 않으면 미리 한 번씩만 구해 두고
+//3개 이하 묶음은 컴파일 시간에 만든 방문 순서 표로, 그보다 크거나 시간대별 프로필을 따라야 하면 (들른 지점 집합, 마지막 지점) DP로 구한다
+double DeliverySystemWithDriverCall::bestDistanceForOrderCombo(const vector<Order*>& orderCombo, const Driver& driver, const Map& map, double departureTime, int worker) {
+    const int STRIDE = 2 * MAX_LIMIT_ORDER_RECEIVE + 1;
+    int k = orderCombo.size();
+    if (k == 0) return 0;
+    if (k > MAX_LIMIT_ORDER_RECEIVE) {
+        cerr << "Error: Order bundle of " << k << " exceeds " << MAX_LIMIT_ORDER_RECEIVE << " orders." << endl;
+        return numeric_limits<double>::max();
+    }
+
+    int stops = 2 * k;
+    int node[STRIDE];   //0번은 기사 위치, 1 + s번은 지점 s
+    node[0] = driver.getCurrentLocation().getNode();
+    for (int i = 0; i < k; i++) {
+        node[1 + i] = orderCombo[i]->getStore()->getLocation().getNode();
+        node[1 + k + i] = orderCombo[i]->getOrderer()->getLocation().getNode();
+    }
 
-    return bestDist;
+    if (roundRow.empty() && map.hasTravelTimeProfiles()) {
+        //다음 지점 출발 시각 = 배차 시각 + 지금까지 소요시간
+        return shortestBundleRouteDP(k, [&](int from, int to, double elapsed) {
+            return legCost(map, node[from], node[to], departureTime + elapsed);
+        }, workerStates[worker].routeCosts);
+    }
+
+    double leg[STRIDE * STRIDE];
+    for (int from = 0; from <= stops; from++) {
+        for (int to = 1; to <= stops; to++) {
+            leg[from * STRIDE + to] = legCost(map, node[from], node[to], departureTime);
+        }
+    }
+    switch (k) {
+    case 1: return shortestBundleRoute<1>(leg, STRIDE);
+    case 2: return shortestBundleRoute<2>(leg, STRIDE);
+    case 3: return shortestBundleRoute<3>(leg, STRIDE);
+    default:
+        return shortestBundleRouteDP(k, [&](int from, int to, double) { return leg[from * STRIDE + to]; }, workerStates[worker].routeCosts);
+    }
 }
 
 double DeliverySystemWithDriverCall::computeEfficiency(const vector<Order*>& group, double totalDist) {
@@ -89,47 +182,312 @@ double DeliverySystemWithDriverCall::computeEfficiency(const vector<Order*>& gro
     return totalFee / totalDist;
 }
 
+double DeliverySystemWithDriverCall::distanceLowerBound(const Order* order, const Driver& driver, const Map& map) {
+    int driverNode = driver.getCurrentLocation().getNode();
+    int storeNode = order->getStore()->getLocation().getNode();
+    int ordererNode = order->getOrderer()->getLocation().getNode();
+    if (!roundRow.empty()) {   //거리표가 있으면 정확한 거리가 가장 좋은 하한
+        return legCost(map, driverNode, storeNode, getCurrentTime()) + legCost(map, storeNode, ordererNode, getCurrentTime());
+    }
+    return map.lowerBound(driverNode, storeNode) + map.lowerBound(storeNode, ordererNode);
+}
+
+double DeliverySystemWithDriverCall::legCost(const Map& map, int from, int to, double departureTime) const {
+    if (!roundRow.empty() && from >= 0 && to >= 0 && from < (int)roundRow.size() && to < (int)roundColumn.size() &&
+        roundRow[from] >= 0 && roundColumn[to] >= 0) {
+        return roundCosts.at(roundRow[from], roundColumn[to]);
+    }
+    return map.GetMap_cost(from, to, departureTime);
+}
+
 void DeliverySystemWithDriverCall::acceptCall() {
     Map& map = getMap();
     vector<Driver>& drivers = getDrivers();
     vector<Order*>& orders = getOrders();
     int limitOrderReceive = getLimitOrderReceive();
-    set<int> assignedOrderIds;
 
-    for (Driver& driver : drivers) {
-        if (!driver.isAvailable()) continue;
-        vector<Order*> availableOrders;
+    //시간대별 프로필이 없으면 이번 배차에 필요한 구간 거리(기사/가게 -> 가게/주문자)를 표 하나로 한 번에 계산.
+    //이웃 후보만 비교할 때는 기사마다 보는 주문이 몇 개 안 되므로 표 없이 쌍별로 계산
+    int neighbors = getCandidateNeighbors();
+    roundRow.clear();
+    roundColumn.clear();
+    if (!map.hasTravelTimeProfiles() && neighbors == 0) {
+        int nodeCount = map.nodes.size();
+        vector<int> sources, targets;
+        roundRow.assign(nodeCount, -1);
+        roundColumn.assign(nodeCount, -1);
+        auto addSource = [&](int node) {
+            if (node < 0 || node >= nodeCount || roundRow[node] >= 0) return;
+            roundRow[node] = sources.size();
+            sources.push_back(node);
+        };
+        auto addTarget = [&](int node) {
+            if (node < 0 || node >= nodeCount || roundColumn[node] >= 0) return;
+            roundColumn[node] = targets.size();
+            targets.push_back(node);
+        };
+        for (const Driver& driver : drivers) {
+            if (driver.isAvailable()) addSource(driver.getCurrentLocation().getNode());
+        }
+        for (const Order* order : orders) {
+            if (order->getStatus() != ORDER_ACCEPTED) continue;
+            int storeNode = order->getStore()->getLocation().getNode();
+            int ordererNode = order->getOrderer()->getLocation().getNode();
+            addSource(storeNode);
+            addSource(ordererNode);
+            addTarget(storeNode);
+            addTarget(ordererNode);
+        }
+        roundCosts = map.GetMap_costTable(sources, targets);
+    }
+    else {
+        map.prepareLowerBounds();
+    }
 
+    prepareBundleCache(map);
+
+    vector<Order*> openOrders;   //전체 비교할 때의 후보 (이번 배차에서 배정되는 주문은 기사마다 빼고 봄)
+    if (neighbors == 0) {
         for (Order* order : orders) {
-            if (order->getStatus() == ORDER_ACCEPTED && !assignedOrderIds.count(order->getOrderId())) {
-                availableOrders.push_back(order);
-            }
+            if (order->getStatus() == ORDER_ACCEPTED) openOrders.push_back(order);
         }
+    }
 
+    //거리 계산이 맵의 탐색 작업 공간을 건드리지 않을 때만 기사들을 나눠 계산
+    bool concurrent = !roundRow.empty() || map.isConcurrentQuerySafe();
+    if (concurrent && getDispatchThreads() != 1 && threadPool().getThreadCount() > 1) {
+        acceptCallParallel(openOrders, limitOrderReceive);
+    }
+    else {
+        acceptCallSerial(openOrders, limitOrderReceive);
+    }
+    flushBundleCache();
+
+    roundRow.clear();   //기사가 움직이면 표가 맞지 않으므로 이번 배차에서만 사용
+    roundColumn.clear();
+    roundCosts = CostMatrix();
+}
+
+void DeliverySystemWithDriverCall::acceptCallSerial(const vector<Order*>& openOrders, int limitOrderReceive) {
+    Map& map = getMap();
+    set<int> assignedOrderIds;
+    for (Driver& driver : getDrivers()) {
+        if (!driver.isAvailable()) continue;
+
+        vector<Order*> availableOrders = candidateOrders(driver, openOrders, assignedOrderIds);
         if (availableOrders.empty()) continue;
+        assignBundle(bestOrderCombo(availableOrders, driver, map, limitOrderReceive), driver, assignedOrderIds);
+        flushBundleCache();   //같은 노드의 다음 기사가 바로 씀
+    }
+}
+
+//기사를 순서대로 (스레드 수 * DRIVERS_PER_WORKER)명씩 묶어 처리.
+//1단계: 묶음 안의 기사마다 그 시점의 후보로 효율 상위 SPECULATIVE_BUNDLES개 묶음을 병렬로 구함 (이 동안 주문, 기사, 공간 색인은 읽기만 함).
+//2단계: 기사 순서대로 앞선 기사가 가져간 주문이 없는 첫 묶음을 배정. 후보 전체의 순위를 남은 주문으로 좁혀도 순서는 그대로이므로
+//그 묶음이 단일 스레드 배차에서 이 기사가 고를 묶음과 같다. 상위 묶음이 모두 겹치면 그 기사만 남은 주문으로 다시 계산하고,
+//이웃 후보는 후보 주문 하나라도 빠지면 다음 이웃이 새로 들어오므로 다시 계산.
+//묶음 단위로 진행하므로 주문이 다 배정된 뒤의 기사들은 단일 스레드처럼 후보 없이 지나간다
+void DeliverySystemWithDriverCall::acceptCallParallel(const vector<Order*>& openOrders, int limitOrderReceive) {
+    Map& map = getMap();
+    vector<Driver>& drivers = getDrivers();
+    int neighbors = getCandidateNeighbors();
+    ThreadPool& workers = threadPool();
+    if ((int)workerStates.size() < workers.getThreadCount()) workerStates.resize(workers.getThreadCount());
+
+    vector<int> availableDrivers;
+    for (int i = 0; i < (int)drivers.size(); i++) {
+        if (drivers[i].isAvailable()) availableDrivers.push_back(i);
+    }
+
+    int batchSize = workers.getThreadCount() * DRIVERS_PER_WORKER;
+    set<int> assignedOrderIds;
+    vector<Order*> remainingOrders;   //전체 비교할 때 이번 묶음의 후보
+    vector<vector<Order*>> neighborOrders(batchSize);
+    vector<vector<vector<Order*>>> rankedBundles(batchSize);
+    auto isAssigned = [&](const Order* order) { return assignedOrderIds.count(order->getOrderId()) > 0; };
 
-        vector<vector<Order*>> orderCombos = generateOrderCombos(availableOrders, limitOrderReceive);
-        double bestEfficiency = -1.0;
-        vector<Order*> bestGroup;
-        for (const auto& group : orderCombos) {
-            double bestDist = bestDistanceForOrderCombo(group, driver, map);
-            double efficiency = computeEfficiency(group, bestDist);
-            if (efficiency > bestEfficiency) {
-                bestEfficiency = efficiency;
-                bestGroup = group;
+    for (int first = 0; first < (int)availableDrivers.size(); first += batchSize) {
+        int count = min(batchSize, (int)availableDrivers.size() - first);
+        if (neighbors == 0) {
+            remainingOrders.clear();
+            for (Order* order : openOrders) {
+                if (!isAssigned(order)) remainingOrders.push_back(order);
             }
+            if (remainingOrders.empty()) break;
         }
 
-        for (Order* order : bestGroup) {
-            if (assignedOrderIds.count(order->getOrderId())) continue;
-            if (order->getStatus() != ORDER_ACCEPTED) continue;
+        workers.parallelFor(count, [&](int worker, int index) {
+            const Driver& driver = drivers[availableDrivers[first + index]];
+            rankedBundles[index].clear();
+            if (neighbors > 0) neighborOrders[index] = nearestOpenOrders(driver.getCurrentLocation(), neighbors);
+            const vector<Order*>& candidates = neighbors > 0 ? neighborOrders[index] : remainingOrders;
+            if (candidates.empty()) return;
+            rankedBundles[index] = rankedOrderCombos(candidates, driver, map, limitOrderReceive, SPECULATIVE_BUNDLES, worker);
+        });
+        flushBundleCache();
 
-            if (assignOrderToDriver(order, driver)) {
-                assignedOrderIds.insert(order->getOrderId());
+        for (int index = 0; index < count; index++) {
+            Driver& driver = drivers[availableDrivers[first + index]];
+            const vector<Order*>* chosen = nullptr;
+            if (neighbors == 0 || none_of(neighborOrders[index].begin(), neighborOrders[index].end(), isAssigned)) {
+                for (const vector<Order*>& bundle : rankedBundles[index]) {
+                    if (none_of(bundle.begin(), bundle.end(), isAssigned)) {
+                        chosen = &bundle;
+                        break;
+                    }
+                }
             }
+            if (chosen) {
+                assignBundle(*chosen, driver, assignedOrderIds);
+                continue;
+            }
+
+            vector<Order*> availableOrders = candidateOrders(driver, openOrders, assignedOrderIds);
+            if (availableOrders.empty()) continue;
+            assignBundle(bestOrderCombo(availableOrders, driver, map, limitOrderReceive), driver, assignedOrderIds);
+        }
+    }
+}
+
+vector<Order*> DeliverySystemWithDriverCall::candidateOrders(const Driver& driver, const vector<Order*>& openOrders, const set<int>& assignedOrderIds) const {
+    int neighbors = getCandidateNeighbors();
+    if (neighbors > 0) {   //가게가 가까운 주문만 후보 (이번 배차에서 이미 배정된 주문은 색인에서 빠져 있음)
+        return nearestOpenOrders(driver.getCurrentLocation(), neighbors);
+    }
+
+    vector<Order*> availableOrders;
+    for (Order* order : openOrders) {
+        if (order->getStatus() == ORDER_ACCEPTED && !assignedOrderIds.count(order->getOrderId())) {
+            availableOrders.push_back(order);
+        }
+    }
+    return availableOrders;
+}
+
+void DeliverySystemWithDriverCall::assignBundle(const vector<Order*>& bundle, Driver& driver, set<int>& assignedOrderIds) {
+    for (Order* order : bundle) {
+        if (assignedOrderIds.count(order->getOrderId())) continue;
+        if (order->getStatus() != ORDER_ACCEPTED) continue;
+
+        if (assignOrderToDriver(order, driver)) {
+            assignedOrderIds.insert(order->getOrderId());
         }
     }
+}
+
+void DeliverySystemWithDriverCall::setBundleCacheCapacity(size_t entries) {
+    bundleCacheCapacity = entries;
+    if (bundleCache.size() > entries) bundleCache.clear();
+}
 
+long long DeliverySystemWithDriverCall::getBundleCacheHits() const {
+    long long hits = 0;
+    for (const WorkerState& state : workerStates) hits += state.cacheHits;
+    return hits;
+}
+
+long long DeliverySystemWithDriverCall::getBundleCacheMisses() const {
+    long long misses = 0;
+    for (const WorkerState& state : workerStates) misses += state.cacheMisses;
+    return misses;
+}
+
+bool DeliverySystemWithDriverCall::BundleKey::operator==(const BundleKey& other) const {
+    if (driverNode != other.driverNode || size != other.size) return false;
+    for (int i = 0; i < size; i++) {
+        if (orderIds[i] != other.orderIds[i]) return false;
+    }
+    return true;
+}
+
+size_t DeliverySystemWithDriverCall::BundleKeyHash::operator()(const BundleKey& key) const {   //FNV-1a 64비트
+    unsigned long long hash = 1469598103934665603ULL;
+    auto mix = [&hash](int value) {
+        hash ^= (unsigned int)value;
+        hash *= 1099511628211ULL;
+    };
+    mix(key.driverNode);
+    for (int i = 0; i < key.size; i++) mix(key.orderIds[i]);
+    return hash;
+}
+
+double DeliverySystemWithDriverCall::bundleDistance(const vector<Order*>& orderCombo, const Driver& driver, const Map& map, int worker) {
+    int k = orderCombo.size();
+    if (!bundleCacheActive || k < bundleCacheMinSize || k > MAX_LIMIT_ORDER_RECEIVE) {
+        return bestDistanceForOrderCombo(orderCombo, driver, map, getCurrentTime(), worker);
+    }
+
+    BundleKey key;
+    key.driverNode = driver.getCurrentLocation().getNode();
+    key.size = k;
+    for (int i = 0; i < k; i++) {   //삽입 정렬 (최대 MAX_LIMIT_ORDER_RECEIVE개)
+        int orderId = orderCombo[i]->getOrderId();
+        int j = i;
+        for (; j > 0 && key.orderIds[j - 1] > orderId; j--) key.orderIds[j] = key.orderIds[j - 1];
+        key.orderIds[j] = orderId;
+    }
+
+    WorkerState& state = workerStates[worker];
+    auto found = bundleCache.find(key);   //병렬 계산 중에는 읽기만 하므로 잠금 없이 찾음
+    if (found != bundleCache.end()) {
+        state.cacheHits++;
+        return found->second;
+    }
+    state.cacheMisses++;
+    double distance = bestDistanceForOrderCombo(orderCombo, driver, map, getCurrentTime(), worker);
+    state.newBundles.push_back({ key, distance });
+    return distance;
+}
+
+void DeliverySystemWithDriverCall::prepareBundleCache(const Map& map) {
+    bool usesTable = !roundRow.empty();
+    bundleCacheActive = bundleCacheCapacity > 0 && (usesTable || !map.hasTravelTimeProfiles());
+    //구간 거리를 탐색 없이 (표나 좌표로) 얻으면 4개 이하 묶음은 다시 계산하는 비용이 캐시 조회와 비슷하거나 더 쌈
+    bundleCacheMinSize = usesTable || map.isConcurrentQuerySafe() ? 5 : 1;
+    if (!bundleCacheActive || map.getCostVersion() != bundleCacheVersion || usesTable != bundleCacheUsesTable) {
+        bundleCache.clear();
+        bundleCacheVersion = map.getCostVersion();
+        bundleCacheUsesTable = usesTable;
+        return;
+    }
+    if (bundleCache.empty()) return;
+
+    //기사가 떠난 노드의 묶음과 이미 배정/취소된 주문이 든 묶음은 다시 찾을 일이 없으므로 버림
+    unordered_set<int> driverNodes;
+    for (const Driver& driver : getDrivers()) {
+        if (driver.isAvailable()) driverNodes.insert(driver.getCurrentLocation().getNode());
+    }
+    unordered_set<int> openOrderIds;
+    for (const Order* order : getOrders()) {
+        if (order->getStatus() == ORDER_ACCEPTED) openOrderIds.insert(order->getOrderId());
+    }
+    for (auto it = bundleCache.begin(); it != bundleCache.end();) {
+        const BundleKey& key = it->first;
+        bool valid = driverNodes.count(key.driverNode) > 0;
+        for (int i = 0; valid && i < key.size; i++) {
+            valid = openOrderIds.count(key.orderIds[i]) > 0;
+        }
+        if (valid) ++it;
+        else it = bundleCache.erase(it);
+    }
+}
+
+void DeliverySystemWithDriverCall::flushBundleCache() {
+    for (WorkerState& state : workerStates) {
+        for (const pair<BundleKey, double>& entry : state.newBundles) {
+            if (bundleCache.size() >= bundleCacheCapacity) break;   //가득 차면 다음 배차 시작 때 정리될 때까지 더 넣지 않음
+            bundleCache.emplace(entry.first, entry.second);
+        }
+        state.newBundles.clear();
+    }
+}
+
+ThreadPool& DeliverySystemWithDriverCall::threadPool() {
+    int threads = getDispatchThreads() > 0 ? getDispatchThreads() : ThreadPool::hardwareThreads();
+    if (!pool || pool->getThreadCount() != threads) {
+        pool.reset(new ThreadPool(threads));
+    }
+    return *pool;
 }
 
 
@@ -1,6 +1,8 @@
 #ifndef DELIVERY_SYSTEM_WITH_DRIVER_CALL_H
 #define DELIVERY_SYSTEM_WITH_DRIVER_CALL_H
 
+#include <set>
+#include <memory>
 #include "delivery_system.h"
 
 class DeliverySystemWithDriverCall : public DeliverySystem {
@@ -10,10 +12,77 @@ public:
 
     void acceptCall() override;
 
+	//배차 사이에 기억해 둘 묶음 거리 수 (0이면 쓰지 않음, 기본 1 << 18). 캐시를 써도 배정 결과는 같다
+	void setBundleCacheCapacity(size_t entries);
+	size_t getBundleCacheSize() const { return bundleCache.size(); }
+	long long getBundleCacheHits() const;     // 캐시에서 찾은 묶음 거리 수 (누적)
+	long long getBundleCacheMisses() const;   // 새로 계산한 묶음 거리 수 (누적)
+
 protected:
-	vector<vector<Order*>> generateOrderCombos(const vector<Order*>& availableOrders, int maxComboSize = 3);
-	double bestDistanceForOrderCombo(const vector<Order*>& orderCombo, const Driver& driver, const Map& map);
+	//availableOrders 중 효율(배달비 / 최단 경로 거리)이 가장 좋은 묶음 (크기 1 ~ maxComboSize). 묶음 목록을 만들지 않고 하나씩 평가하며,
+	//효율 상한이 지금까지의 최고를 넘지 못하는 묶음은 같은 접두사로 시작하는 것까지 통째로 건너뜀
+	vector<Order*> bestOrderCombo(const vector<Order*>& availableOrders, const Driver& driver, const Map& map, int maxComboSize);
+	//효율이 좋은 순서로 최대 count개 묶음 (효율이 같으면 bestOrderCombo에서 먼저 나오는 묶음이 앞). worker는 병렬 배차의 작업 스레드 번호
+	vector<vector<Order*>> rankedOrderCombos(const vector<Order*>& availableOrders, const Driver& driver, const Map& map, int maxComboSize, int count, int worker = 0);
+	double bestDistanceForOrderCombo(const vector<Order*>& orderCombo, const Driver& driver, const Map& map, double departureTime, int worker = 0);
 	double computeEfficiency(const vector<Order*>& group, double totalDist);
+	double distanceLowerBound(const Order* order, const Driver& driver, const Map& map);   // 기사가 이 주문 하나를 처리하는 거리의 하한 (기사 -> 가게 -> 주문자)
+	double legCost(const Map& map, int from, int to, double departureTime) const;   // 이번 배차의 거리표에 있으면 표에서, 없으면 map에서 계산
+
+	// 이번 배차에서 쓰는 거리표 (기사/가게 위치 -> 가게/주문자 위치). 시간대별 프로필이 있으면 만들지 않음
+	CostMatrix roundCosts;
+	vector<int> roundRow;      // 노드 -> roundCosts 행 (-1이면 없음)
+	vector<int> roundColumn;   // 노드 -> roundCosts 열
+
+private:
+	// 묶음 거리 캐시 키: 기사 노드 + 정렬한 주문 ID (최단 경로 길이는 묶음 안 주문 순서와 무관)
+	struct BundleKey {
+		int driverNode;
+		int size;
+		int orderIds[MAX_LIMIT_ORDER_RECEIVE];
+
+		bool operator==(const BundleKey& other) const;
+	};
+	struct BundleKeyHash {
+		size_t operator()(const BundleKey& key) const;
+	};
+
+	// 작업 스레드별 상태 (병렬 배차에서 스레드마다 따로 씀)
+	struct WorkerState {
+		vector<double> routeCosts;   // bestDistanceForOrderCombo DP 작업 공간 ((들른 지점 집합, 마지막 지점) -> 최소 소요시간), 한 번 늘린 뒤 재사용
+		vector<pair<BundleKey, double>> newBundles;   // 이번에 새로 계산한 묶음 거리 (병렬 계산이 끝난 뒤 bundleCache에 넣음)
+		long long cacheHits = 0;
+		long long cacheMisses = 0;
+	};
+
+	//병렬 배차에서 기사 한 명당 미리 구해 두는 묶음 수. 앞선 기사와 겹치지 않는 묶음이 이 안에 없으면 그 기사만 다시 계산
+	static constexpr int SPECULATIVE_BUNDLES = 4;
+	//병렬 배차에서 한 번에 미리 계산하는 기사 수 = 스레드 수 * DRIVERS_PER_WORKER (클수록 스레드가 고르게 바쁘지만 겹침이 늘어남)
+	static constexpr int DRIVERS_PER_WORKER = 8;
+
+	unique_ptr<ThreadPool> pool;   // threadPool()로 처음 쓸 때 생성
+	vector<WorkerState> workerStates;
+
+	// 배차 사이에 유지하는 묶음 거리 (기사 노드, 주문들) -> bestDistanceForOrderCombo 결과.
+	// 맵 거리가 바뀌거나(Map::getCostVersion) 거리표 사용 여부가 바뀌면 전부, 기사가 떠난 노드나 ORDER_ACCEPTED가 아닌 주문이 든 묶음은 배차 시작 때 버림.
+	// 출발 시각에 따라 거리가 바뀌는 배차에서는 쓰지 않음. 단일 스레드 배차는 기사마다, 병렬 배차는 병렬 계산이 끝날 때마다 새 값을 넣는다
+	unordered_map<BundleKey, double, BundleKeyHash> bundleCache;
+	size_t bundleCacheCapacity = 1 << 18;
+	bool bundleCacheActive = false;   // 이번 배차에서 캐시를 쓰는지
+	int bundleCacheMinSize = 1;       // 이번 배차에서 캐시하는 가장 작은 묶음
+	unsigned long long bundleCacheVersion = 0;
+	bool bundleCacheUsesTable = false;
+
+	double bundleDistance(const vector<Order*>& orderCombo, const Driver& driver, const Map& map, int worker);   // 캐시를 거친 bestDistanceForOrderCombo
+	void prepareBundleCache(const Map& map);
+	void flushBundleCache();   // 작업 스레드들이 새로 계산한 묶음 거리를 캐시에 넣음 (병렬 계산 중에는 호출하지 않음)
+
+	ThreadPool& threadPool();
+	//openOrders는 배차 시작 시점의 미배정 주문. 두 방식의 배정 결과는 같다
+	void acceptCallSerial(const vector<Order*>& openOrders, int limitOrderReceive);
+	void acceptCallParallel(const vector<Order*>& openOrders, int limitOrderReceive);
+	vector<Order*> candidateOrders(const Driver& driver, const vector<Order*>& openOrders, const set<int>& assignedOrderIds) const;   // 이 기사가 지금 비교할 주문
+	void assignBundle(const vector<Order*>& bundle, Driver& driver, set<int>& assignedOrderIds);
 
 };
 
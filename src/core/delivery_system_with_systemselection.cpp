@@ -4,6 +4,7 @@
 #include <vector>
 #include <queue>
 #include <algorithm>
+#include <unordered_map>
 
 using namespace std;
 
@@ -11,25 +12,18 @@ DeliverySystemWithSystemSelection::DeliverySystemWithSystemSelection() : Deliver
 
 DeliverySystemWithSystemSelection::~DeliverySystemWithSystemSelection() = default;
 
-class DistanceAndNode {
+// 한 기사의 주문별 거리 (기사 -> 가게 -> 주문자)
+// 배차 알고리즘은 매번 각 기사의 가장 가까운 두 주문만 보므로 거리를 전부 계산하지 않는다.
+// 하한이 작은 주문부터 정확한 거리를 계산하다가, 다음 주문의 하한이 필요한 순위의 거리보다 크면 멈춘다.
+class CandidateRow {
 public:
-    DistanceAndNode(double dis, int d, int o) {
-        distance = dis;
-        driver = d;
-        order = o;
-    }
-
-
-    double distance;
     int driver;
-    int order;
+    double rowMin;                      // 행의 최솟값 (거리 비교는 이 값을 뺀 거리로)
+    vector<pair<double, int>> bounds;   // (거리 하한, 주문 번호), 오름차순
+    size_t cursor = 0;                  // bounds에서 아직 정확한 거리를 계산하지 않은 첫 위치
+    vector<pair<double, int>> exact;    // (거리, 주문 번호), 계산했고 아직 배차되지 않은 주문만, 오름차순
 };
 
-
-bool sort_dis(DistanceAndNode* a, DistanceAndNode* b) {
-    return a->distance < b->distance;
-}
-
 void DeliverySystemWithSystemSelection::acceptCall() {
     vector<Driver>& drivers = getDrivers();
     vector<Order*>& orders = getOrders();
@@ -46,142 +40,183 @@ void DeliverySystemWithSystemSelection::acceptCall() {
         return;
     }
     
-    if (map.map_cost == nullptr) {
+    if (!map.isInitialized()) {
         return;
     }
-    
-    double** distance_arr;
-    vector<vector<DistanceAndNode*>> vector_arr;
-
-    distance_arr = new double* [drivers.size()];
-    for (int i = 0;i < drivers.size();i++) {
-        distance_arr[i] = new double[acceptedOrders.size()];
-
-        vector<DistanceAndNode*> temp;
 
-        double min = INT_MAX;
+    vector<char> driverValid(drivers.size(), 0);
+    vector<char> orderValid(acceptedOrders.size(), 0);
+    int nodeCount = map.nodes.size();
+    for (int i = 0; i < (int)drivers.size(); i++) {
+        int node = drivers[i].getCurrentLocation().node;
+        driverValid[i] = node != -1 && node < nodeCount;
+    }
+    for (int j = 0; j < (int)acceptedOrders.size(); j++) {
+        const Store* orderStore = acceptedOrders[j]->getStore();
+        const Orderer* orderOrderer = acceptedOrders[j]->getOrderer();
+        if (!orderStore || !orderOrderer) continue;
+        int storeNode = orderStore->getLocation().node;
+        int ordererNode = orderOrderer->getLocation().node;
+        orderValid[j] = storeNode != -1 && ordererNode != -1 && storeNode < nodeCount && ordererNode < nodeCount;
+    }
 
-        for (int j = 0;j < (int)acceptedOrders.size();j++) {
-            const Store* orderStore = acceptedOrders[j]->getStore();
-            const Orderer* orderOrderer = acceptedOrders[j]->getOrderer();
-            
-            if (!orderStore || !orderOrderer) {
-                distance_arr[i][j] = INT_MAX;
-                continue;
-            }
-            
-            const Location& storeLoc = orderStore->getLocation();
-            const Location& ordererLoc = orderOrderer->getLocation();
-            const Location& driverLoc = drivers[i].getCurrentLocation();
-            
-            if (storeLoc.node == -1 || ordererLoc.node == -1 || driverLoc.node == -1) {
-                distance_arr[i][j] = INT_MAX;
-                continue;
+    //시간대별 프로필이 없으면 필요한 거리를 표 두 개(기사 x 가게, 가게 x 주문자)로 한 번에 계산.
+    //프로필이 있으면 구간마다 출발 시각이 달라서 쌍별로 계산하되, 아래의 하한 순서 덕분에 필요한 쌍만 계산한다
+    int neighbors = getCandidateNeighbors();
+    bool batched = !map.hasTravelTimeProfiles() && neighbors == 0;
+    CostMatrix driverToStore, storeToOrderer;
+    vector<int> driverRow(drivers.size(), -1), storeIndex(acceptedOrders.size(), -1), ordererIndex(acceptedOrders.size(), -1);
+    if (batched) {
+        vector<int> driverNodes, storeNodes, ordererNodes;
+        vector<int> storePosition(nodeCount, -1), ordererPosition(nodeCount, -1);
+        for (int i = 0; i < (int)drivers.size(); i++) {
+            if (!driverValid[i]) continue;
+            driverRow[i] = driverNodes.size();
+            driverNodes.push_back(drivers[i].getCurrentLocation().node);
+        }
+        for (int j = 0; j < (int)acceptedOrders.size(); j++) {
+            if (!orderValid[j]) continue;
+            int storeNode = acceptedOrders[j]->getStore()->getLocation().node;
+            int ordererNode = acceptedOrders[j]->getOrderer()->getLocation().node;
+            if (storePosition[storeNode] < 0) {
+                storePosition[storeNode] = storeNodes.size();
+                storeNodes.push_back(storeNode);
             }
-            
-            if (storeLoc.node >= (int)map.nodes.size() || ordererLoc.node >= (int)map.nodes.size() || 
-                driverLoc.node >= (int)map.nodes.size()) {
-                distance_arr[i][j] = INT_MAX;
-                continue;
+            if (ordererPosition[ordererNode] < 0) {
+                ordererPosition[ordererNode] = ordererNodes.size();
+                ordererNodes.push_back(ordererNode);
             }
-
-            double cost1 = map.map_cost[storeLoc.node][driverLoc.node];
-            double cost2 = map.map_cost[ordererLoc.node][storeLoc.node];
-            
-            distance_arr[i][j] = cost1 + cost2;
-
-            if (distance_arr[i][j] < min) min = distance_arr[i][j];
+            storeIndex[j] = storePosition[storeNode];
+            ordererIndex[j] = ordererPosition[ordererNode];
         }
+        driverToStore = map.GetMap_costTable(driverNodes, storeNodes);
+        storeToOrderer = map.GetMap_costTable(storeNodes, ordererNodes);
+    }
 
-        for (int j = 0;j < (int)acceptedOrders.size();j++) {
-            distance_arr[i][j] -= min;
-
-            temp.push_back(new DistanceAndNode(distance_arr[i][j], i, j));
+    //기사 i가 주문 j를 처리하는 거리. exact가 false면 하한만 계산 (탐색 없음)
+    if (!batched) map.prepareLowerBounds();
+    auto distance = [&](int i, int j, bool exact) -> double {
+        if (!driverValid[i] || !orderValid[j]) return INT_MAX;
+        if (batched) {   //표에서 읽는 거리는 하한 대신 그대로 써서 정렬
+            return driverToStore.at(driverRow[i], storeIndex[j]) + storeToOrderer.at(storeIndex[j], ordererIndex[j]);
         }
 
-        sort(temp.begin(), temp.end(), sort_dis);
-
-        vector_arr.push_back(temp);
+        int storeNode = acceptedOrders[j]->getStore()->getLocation().node;
+        int ordererNode = acceptedOrders[j]->getOrderer()->getLocation().node;
+        int driverNode = drivers[i].getCurrentLocation().node;
+        if (!exact) {
+            return map.lowerBound(driverNode, storeNode) + map.lowerBound(storeNode, ordererNode);
+        }
+        double cost1 = map.GetMap_cost(driverNode, storeNode, getCurrentTime());
+        double cost2 = map.GetMap_cost(storeNode, ordererNode, getCurrentTime() + cost1);
+        return cost1 + cost2;
+    };
+
+    vector<char> assigned(acceptedOrders.size(), 0);
+    int remaining = acceptedOrders.size();
+
+    //row.exact의 앞 count개가 남은 주문 중 가장 가까운 count개가 되도록 필요한 만큼만 정확한 거리 계산
+    auto ensure = [&](CandidateRow& row, size_t count) {
+        while (row.cursor < row.bounds.size() &&
+               (row.exact.size() < count || row.bounds[row.cursor].first <= row.exact[count - 1].first)) {
+            int j = row.bounds[row.cursor++].second;
+            if (assigned[j]) continue;
+            pair<double, int> entry(distance(row.driver, j, true), j);
+            row.exact.insert(upper_bound(row.exact.begin(), row.exact.end(), entry), entry);
+        }
+    };
+
+    //이웃 후보 모드에서는 어떤 주문의 가까운 k명 안에 드는 배차 가능한 기사만 행을 만들고,
+    //각 행에는 가게가 가까운 주문 k개만 넣는다 (나머지 주문은 거리 무한대 취급)
+    vector<char> candidateDriver(drivers.size(), neighbors == 0);
+    if (neighbors > 0) {
+        for (Order* order : acceptedOrders) {
+            if (!order->getStore()) continue;
+            for (int i : nearestAvailableDrivers(order->getStore()->getLocation(), neighbors)) candidateDriver[i] = 1;
+        }
     }
 
-    vector<DistanceAndNode*> result;
-
-    while (true) {
-        if (vector_arr.size() == 0) break;
-        if (vector_arr[0].size() == 0) break;
-
-        if (vector_arr.size() == 1) {   //남은 기사가 한명
-            result.push_back(vector_arr[0][0]);
-
-            for (int i = 1; i < vector_arr[0].size(); i++)
-            {
-                delete vector_arr[0][i];
+    vector<CandidateRow> rows;
+    unordered_map<int, int> acceptedIndex;   // 주문 ID -> acceptedOrders 인덱스
+    for (int j = 0; j < (int)acceptedOrders.size(); j++) acceptedIndex[acceptedOrders[j]->getOrderId()] = j;
+    for (int i = 0; i < (int)drivers.size(); i++) {
+        if (!candidateDriver[i]) continue;
+        rows.emplace_back();
+        CandidateRow& row = rows.back();
+        row.driver = i;
+        if (neighbors > 0) {
+            for (Order* order : nearestOpenOrders(drivers[i].getCurrentLocation(), neighbors)) {
+                int j = acceptedIndex.at(order->getOrderId());
+                row.bounds.push_back({ distance(i, j, false), j });
             }
-
-            break;
         }
-
-        if (vector_arr[0].size() == 1) {  //남은 주문이 1개
-            result.push_back(vector_arr[0][0]);
-
-            for (int i = 1; i < vector_arr.size(); i++)
-            {
-                delete vector_arr[i][0];
+        else {
+            for (int j = 0; j < (int)acceptedOrders.size(); j++) {
+                row.bounds.push_back({ distance(i, j, false), j });
             }
+        }
+        sort(row.bounds.begin(), row.bounds.end());
+
+        ensure(row, 1);
+        row.rowMin = !row.exact.empty() && row.exact[0].first < INT_MAX ? row.exact[0].first : INT_MAX;
+    }
 
+    vector<pair<int, int>> result;   // (기사, 주문)
+    vector<int> active(rows.size());
+    for (int i = 0; i < (int)rows.size(); i++) active[i] = i;
+
+    while (!active.empty() && remaining > 0) {
+        //후보가 모두 다른 기사에게 간 기사는 제외 (전체 비교에서는 주문이 남아 있는 한 생기지 않음)
+        active.erase(remove_if(active.begin(), active.end(), [&](int i) {
+            ensure(rows[i], 1);
+            return rows[i].exact.empty();
+            }), active.end());
+        if (active.empty()) break;
+
+        if (active.size() == 1 || remaining == 1) {   //남은 기사가 한명이거나 남은 주문이 1개
+            CandidateRow& row = rows[active[0]];
+            ensure(row, 1);
+            result.push_back({ row.driver, row.exact[0].second });
             break;
         }
 
-
-        //배차 알고리즘
+        //배차 알고리즘: 가장 가까운 주문과 두 번째 주문의 차이가 가장 작은 기사부터 가장 가까운 주문을 배정
         double min = INT_MAX;
-        int index_i;
-        DistanceAndNode* temp;
-        for (int i = 0;i < vector_arr.size();i++) {
-            double value = vector_arr[i][1]->distance - vector_arr[i][0]->distance;
+        int index_i = 0;
+        for (int i = 0; i < (int)active.size(); i++) {
+            CandidateRow& row = rows[active[i]];
+            ensure(row, 2);
+            double second = row.exact.size() > 1 ? row.exact[1].first : INT_MAX;
+            double value = (second - row.rowMin) - (row.exact[0].first - row.rowMin);
 
             if (value < min) {
                 min = value;
-
                 index_i = i;
-                temp = vector_arr[i][0];
             }
         }
 
-        for (int i = 1; i < vector_arr[index_i].size(); i++)
-        {
-            delete vector_arr[index_i][i];
-        }
-        vector_arr.erase(vector_arr.begin() + index_i);
-
-        for (int i = 0;i < vector_arr.size();i++) {
-            for (int j = 0; j < vector_arr[i].size(); j++)
-            {
-                if (vector_arr[i][j]->order == temp->order) {
-                    delete vector_arr[i][j];
-                    vector_arr[i].erase(vector_arr[i].begin() + j);
+        CandidateRow& chosen = rows[active[index_i]];
+        int order = chosen.exact[0].second;
+        result.push_back({ chosen.driver, order });
+        active.erase(active.begin() + index_i);
+        assigned[order] = 1;
+        remaining--;
+
+        for (int i : active) {
+            vector<pair<double, int>>& exact = rows[i].exact;
+            for (int k = 0; k < (int)exact.size(); k++) {
+                if (exact[k].second == order) {
+                    exact.erase(exact.begin() + k);
                     break;
                 }
             }
         }
-
-        result.push_back(temp);
     }
 
 
     for (int i = 0;i < (int)result.size();i++) {
-        int driverId = result[i]->driver;
-        int orderIdx = result[i]->order;
-        Order* order = acceptedOrders[orderIdx];
-        
-        drivers[driverId].addOrder(order);
-        order->assignDriver(drivers[driverId].getId());
-        
-        delete result[i];
-    }
-    
-    for (int i = 0; i < (int)drivers.size(); i++) {
-        delete[] distance_arr[i];
+        int driverId = result[i].first;
+        int orderIdx = result[i].second;
+        assignOrderToDriver(acceptedOrders[orderIdx], drivers[driverId]);
     }
-    delete[] distance_arr;
 }
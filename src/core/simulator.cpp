@@ -2,6 +2,7 @@
 #include "../entities/order.h"
 #include "delivery_system_with_drivercall.h"
 #include "delivery_system_with_systemselection.h"
+#include "../utils/distance_kernel.h"
 #include <sstream>
 #include <iomanip>
 #include <fstream>
@@ -857,6 +858,17 @@ void Simulator::runRealTimeSimulation() {
         map<int, Location> driverTargets; // 기사별 목적지
         map<int, Location> driverStartPositions; // 기사별 이동 시작 위치
         map<int, double> driverStartTimes; // 기사별 이동 시작 시간
+        // 이동 중인 기사와 목적지를 먼저 모은 뒤 거리는 DistanceKernel로 한 번에 계산
+        struct DriverMove {
+            int driverId;
+            int orderId;
+            int state;
+            Order* order;
+            Location target;
+            bool moved;
+        };
+        vector<DriverMove> moves;
+        PointArrays currentPoints, targetPoints;
 
         for (auto& driverPair : driverStates) {
             int driverId = driverPair.first;
@@ -877,56 +889,78 @@ void Simulator::runRealTimeSimulation() {
                     }
                 }
 
+                DriverMove move = { driverId, orderId, state, order, Location(), false };
                 if (order) {
-                    Location currentPos = driverLocations[driverId];
-                    Location targetPos;
-
                     if (state == 1) { // 픽업 중 - 매장으로 이동
-                        targetPos = order->getStore()->getLocation();
+                        move.target = order->getStore()->getLocation();
                     } else { // 배달 중 - 배달지로 이동
-                        targetPos = order->getDeliveryLocation();
+                        move.target = order->getDeliveryLocation();
                     }
+                    currentPoints.add(driverLocations[driverId]);
+                    targetPoints.add(move.target);
+                }
+                moves.push_back(move);
+            }
+        }
 
-                    // 목적지와의 거리 계산
-                    double distanceToTarget = currentPos.calculateDistance(targetPos);
+        // 목적지와의 거리 계산
+        vector<double> distanceToTarget(currentPoints.size());
+        DistanceKernel::pairwise(currentPoints, targetPoints, distanceToTarget.data());
+
+        PointArrays movedPoints, movedTargets;
+        int measured = 0;
+        for (DriverMove& move : moves) {
+            if (!move.order) continue;
+            if (distanceToTarget[measured++] <= DRIVER_SPEED) continue;
+
+            // 아직 목적지에 도착하지 않음 - 이동 계속
+            Location currentPos = driverLocations[move.driverId];
+            double dx = move.target.getX() - currentPos.getX();
+            double dy = move.target.getY() - currentPos.getY();
+            double totalDistance = sqrt(dx * dx + dy * dy);
+
+            // 단위벡터 계산 (방향)
+            double unitX = dx / totalDistance;
+            double unitY = dy / totalDistance;
+
+            // 속도에 따른 새로운 위치 계산
+            double newX = currentPos.getX() + (unitX * DRIVER_SPEED);
+            double newY = currentPos.getY() + (unitY * DRIVER_SPEED);
+
+            // 위치 업데이트
+            driverLocations[move.driverId] = Location((int)round(newX), (int)round(newY));
+            move.moved = true;
+            movedPoints.add(driverLocations[move.driverId]);
+            movedTargets.add(move.target);
+        }
 
-                    if (distanceToTarget > DRIVER_SPEED) {
-                        // 아직 목적지에 도착하지 않음 - 이동 계속
-                        double dx = targetPos.getX() - currentPos.getX();
-                        double dy = targetPos.getY() - currentPos.getY();
-                        double totalDistance = sqrt(dx * dx + dy * dy);
-
-                        // 단위벡터 계산 (방향)
-                        double unitX = dx / totalDistance;
-                        double unitY = dy / totalDistance;
-
-                        // 속도에 따른 새로운 위치 계산
-                        double newX = currentPos.getX() + (unitX * DRIVER_SPEED);
-                        double newY = currentPos.getY() + (unitY * DRIVER_SPEED);
-
-                        // 위치 업데이트
-                        driverLocations[driverId] = Location((int)round(newX), (int)round(newY));
-
-                        // 이동 로그 출력
-                        cout << "[이동 " << currentTime << "초] 기사 #" << driverId
-                             << (state == 1 ? "(픽업중)" : "(배달중)")
-                             << ": (" << (int)round(newX) << ", " << (int)round(newY)
-                             << ") → 목적지: (" << targetPos.getX() << ", " << targetPos.getY()
-                             << "), 남은 거리: " << fixed << setprecision(1)
-                             << driverLocations[driverId].calculateDistance(targetPos) << endl;
-                    }
-                } else {
-                    // 유효하지 않은 주문 참조 처리 - 주문이 이미 완료되어 제거된 경우
-                    cout << "[경고 " << currentTime << "초] 기사 #" << driverId
-                         << " 이동 중 참조하던 주문 ID: " << orderId << "가 존재하지 않음. 기사 상태 초기화." << endl;
+        vector<double> remainingDistance(movedPoints.size());
+        DistanceKernel::pairwise(movedPoints, movedTargets, remainingDistance.data());
+
+        // 기사 순서대로 이동 로그 출력
+        int movedCount = 0;
+        for (const DriverMove& move : moves) {
+            int driverId = move.driverId;
+            if (move.order) {
+                if (!move.moved) continue;
+                const Location& newPos = driverLocations[driverId];
+                cout << "[이동 " << currentTime << "초] 기사 #" << driverId
+                     << (move.state == 1 ? "(픽업중)" : "(배달중)")
+                     << ": (" << newPos.getX() << ", " << newPos.getY()
+                     << ") → 목적지: (" << move.target.getX() << ", " << move.target.getY()
+                     << "), 남은 거리: " << fixed << setprecision(1)
+                     << remainingDistance[movedCount++] << endl;
+            } else {
+                // 유효하지 않은 주문 참조 처리 - 주문이 이미 완료되어 제거된 경우
+                cout << "[경고 " << currentTime << "초] 기사 #" << driverId
+                     << " 이동 중 참조하던 주문 ID: " << move.orderId << "가 존재하지 않음. 기사 상태 초기화." << endl;
 
-                    // 기사 상태를 대기 상태로 초기화
-                    driverStates[driverId] = 0; // 대기 상태로 변경
-                    driverCurrentOrder[driverId] = -1; // 주문 참조 해제
+                // 기사 상태를 대기 상태로 초기화
+                driverStates[driverId] = 0; // 대기 상태로 변경
+                driverCurrentOrder[driverId] = -1; // 주문 참조 해제
 
-                    // 기사를 즉시 새로운 배차 대상으로 만들기 위해 완료 플래그 설정
-                    driverCompleted = true;
-                }
+                // 기사를 즉시 새로운 배차 대상으로 만들기 위해 완료 플래그 설정
+                driverCompleted = true;
             }
         }
 
@@ -948,6 +982,7 @@ void Simulator::runRealTimeSimulation() {
 
         // 배차 처리
         if (shouldCallDispatch && deliverySystem && !pendingOrders.empty()) {
+            deliverySystem->setCurrentTime(currentTime);
             deliverySystem->acceptCall();
             lastDispatchTime = currentTime;
 
@@ -0,0 +1,447 @@
+#include "contraction_hierarchy.h"
+#include <climits>
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+namespace {
+
+const int WITNESS_SETTLE_LIMIT = 500;           // witness 탐색에서 확정할 최대 노드 수 (넘으면 shortcut을 보수적으로 추가)
+const int SIMULATE_WITNESS_SETTLE_LIMIT = 25;   // 우선순위 계산용 모의 축약에서는 탐색을 짧게 끊음
+
+typedef vector<pair<int, double>> ArcList;
+
+void addArc(ArcList& arcs, int target, double weight) {   // 같은 간선이 이미 있으면 더 짧은 쪽만 유지
+    for (pair<int, double>& arc : arcs) {
+        if (arc.first == target) {
+            if (weight < arc.second) arc.second = weight;
+            return;
+        }
+    }
+    arcs.push_back({ target, weight });
+}
+
+void removeArc(ArcList& arcs, int target) {
+    for (int i = 0; i < (int)arcs.size(); i++) {
+        if (arcs[i].first == target) {
+            arcs[i] = arcs.back();
+            arcs.pop_back();
+            return;
+        }
+    }
+}
+
+// 축약 중인 그래프와 witness 탐색용 작업 공간
+struct ContractionGraph {
+    vector<ArcList> out;
+    vector<ArcList> in;
+    vector<char> contracted;
+    vector<int> contractedNeighbors;
+    vector<int> level;                      // 축약된 이웃들의 최대 깊이 + 1 (계층이 한쪽으로 깊어지는 것을 막음)
+
+    vector<double> witnessDist;
+    vector<int> witnessStamp;
+    vector<int> targetStamp;
+    vector<pair<double, int>> heap;
+    int stamp = 0;
+
+    // source에서 출발해 skip 노드를 거치지 않고 limit 이하인 최단거리 탐색 (witnessDist에 기록)
+    // targetStamp가 현재 stamp인 노드 targetCount개가 모두 확정되면 일찍 끝냄
+    void witnessSearch(int source, int skip, double limit, int settleLimit, int targetCount) {
+        greater<pair<double, int>> heapOrder;
+        witnessStamp[source] = stamp;
+        witnessDist[source] = 0;
+
+        heap.clear();
+        heap.push_back({ 0.0, source });
+        int settled = 0;
+
+        while (!heap.empty() && settled < settleLimit && targetCount > 0) {
+            pop_heap(heap.begin(), heap.end(), heapOrder);
+            double d = heap.back().first;
+            int u = heap.back().second;
+            heap.pop_back();
+
+            if (d > witnessDist[u]) continue;
+            if (d > limit) break;
+            settled++;
+            if (targetStamp[u] == stamp) targetCount--;
+
+            for (const pair<int, double>& arc : out[u]) {
+                int v = arc.first;
+                if (v == skip || contracted[v]) continue;
+
+                double cost = d + arc.second;
+                if (witnessStamp[v] != stamp || cost < witnessDist[v]) {
+                    witnessStamp[v] = stamp;
+                    witnessDist[v] = cost;
+                    heap.push_back({ cost, v });
+                    push_heap(heap.begin(), heap.end(), heapOrder);
+                }
+            }
+        }
+    }
+
+    double reached(int node) const {
+        return witnessStamp[node] == stamp ? witnessDist[node] : INT_MAX;
+    }
+
+    // node를 축약할 때 필요한 shortcut을 구함. apply가 true면 실제로 그래프에 추가
+    int contract(int node, bool apply) {
+        int shortcuts = 0;
+
+        for (const pair<int, double>& inArc : in[node]) {
+            int from = inArc.first;
+            if (contracted[from]) continue;
+
+            stamp++;
+            double maxOut = -1;
+            int targetCount = 0;
+            for (const pair<int, double>& outArc : out[node]) {
+                if (contracted[outArc.first] || outArc.first == from) continue;
+                maxOut = max(maxOut, outArc.second);
+                targetStamp[outArc.first] = stamp;
+                targetCount++;
+            }
+            if (maxOut < 0) continue;
+
+            witnessSearch(from, node, inArc.second + maxOut, apply ? WITNESS_SETTLE_LIMIT : SIMULATE_WITNESS_SETTLE_LIMIT, targetCount);
+
+            for (const pair<int, double>& outArc : out[node]) {
+                int to = outArc.first;
+                if (contracted[to] || to == from) continue;
+
+                double viaNode = inArc.second + outArc.second;
+                if (reached(to) <= viaNode) continue;   // node를 거치지 않는 경로(witness)가 있으면 shortcut 불필요
+
+                shortcuts++;
+                if (apply) {
+                    addArc(out[from], to, viaNode);
+                    addArc(in[to], from, viaNode);
+                }
+            }
+        }
+
+        return shortcuts;
+    }
+
+    int priority(int node) {   // edge difference + 이미 축약된 이웃 수 + 깊이 (낮을수록 먼저 축약)
+        int degree = 0;
+        for (const pair<int, double>& arc : in[node]) if (!contracted[arc.first]) degree++;
+        for (const pair<int, double>& arc : out[node]) if (!contracted[arc.first]) degree++;
+
+        return 2 * (contract(node, false) - degree) + contractedNeighbors[node] + level[node];
+    }
+};
+
+void buildUpwardGraph(const vector<vector<pair<int, double>>>& arcs, vector<int>& offsets, vector<int>& targets, vector<double>& weights) {
+    int n = arcs.size();
+    offsets.assign(n + 1, 0);
+    targets.clear();
+    weights.clear();
+
+    for (int u = 0; u < n; u++) {
+        for (const pair<int, double>& arc : arcs[u]) {
+            targets.push_back(arc.first);
+            weights.push_back(arc.second);
+        }
+        offsets[u + 1] = targets.size();
+    }
+}
+
+// 상향 간선만 따라가는 전체 탐색 (many-to-many용). 정지(stall)되지 않고 확정된 노드를 settled에 기록
+struct UpwardSearch {
+    vector<double> dist;
+    vector<int> stamp;
+    int currentStamp = 0;
+    vector<pair<double, int>> heap;
+    vector<pair<int, double>> settled;
+
+    void run(int source, const vector<int>& offsets, const vector<int>& targets, const vector<double>& weights,
+             const vector<int>& stallOffsets, const vector<int>& stallTargets, const vector<double>& stallWeights) {
+        greater<pair<double, int>> heapOrder;
+        currentStamp++;
+        settled.clear();
+        heap.clear();
+        stamp[source] = currentStamp;
+        dist[source] = 0;
+        heap.push_back({ 0.0, source });
+
+        while (!heap.empty()) {
+            pop_heap(heap.begin(), heap.end(), heapOrder);
+            double d = heap.back().first;
+            int u = heap.back().second;
+            heap.pop_back();
+            if (d > dist[u]) continue;
+
+            bool stalled = false;
+            for (int e = stallOffsets[u]; e < stallOffsets[u + 1] && !stalled; e++) {
+                int v = stallTargets[e];
+                stalled = stamp[v] == currentStamp && dist[v] + stallWeights[e] < d;
+            }
+            if (stalled) continue;
+            settled.push_back({ u, d });
+
+            for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+                int v = targets[e];
+                double cost = d + weights[e];
+                if (stamp[v] != currentStamp || cost < dist[v]) {
+                    stamp[v] = currentStamp;
+                    dist[v] = cost;
+                    heap.push_back({ cost, v });
+                    push_heap(heap.begin(), heap.end(), heapOrder);
+                }
+            }
+        }
+    }
+};
+
+}
+
+ContractionHierarchy::ContractionHierarchy() : nodeCount(0), shortcutCount(0), currentStamp(0) {}
+
+void ContractionHierarchy::build(int nodeCount_in, const vector<int>& offsets, const vector<int>& targets, const vector<double>& weights) {
+    clear();
+    nodeCount = nodeCount_in;
+
+    ContractionGraph graph;
+    graph.out.assign(nodeCount, ArcList());
+    graph.in.assign(nodeCount, ArcList());
+    graph.contracted.assign(nodeCount, 0);
+    graph.contractedNeighbors.assign(nodeCount, 0);
+    graph.level.assign(nodeCount, 0);
+    graph.witnessDist.assign(nodeCount, 0);
+    graph.witnessStamp.assign(nodeCount, 0);
+    graph.targetStamp.assign(nodeCount, 0);
+
+    for (int u = 0; u < nodeCount; u++) {
+        for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+            if (targets[e] == u) continue;
+            addArc(graph.out[u], targets[e], weights[e]);
+            addArc(graph.in[targets[e]], u, weights[e]);
+        }
+    }
+
+    // 우선순위가 가장 낮은 노드부터 축약. 꺼낸 노드의 우선순위를 다시 계산해 밀렸으면 되돌려 넣음 (lazy update)
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+    for (int v = 0; v < nodeCount; v++) {
+        pq.push({ graph.priority(v), v });
+    }
+
+    // 축약되는 노드의 남은 간선은 모두 자신보다 나중(상위)에 축약될 노드로 향하므로 그대로 상향 그래프가 된다
+    vector<ArcList> up(nodeCount), down(nodeCount);
+    rank.assign(nodeCount, 0);
+    int order = 0;
+    vector<int> neighbors;
+    while (!pq.empty()) {
+        int v = pq.top().second;
+        pq.pop();
+
+        int current = graph.priority(v);
+        if (!pq.empty() && current > pq.top().first) {
+            pq.push({ current, v });
+            continue;
+        }
+
+        shortcutCount += graph.contract(v, true);
+        graph.contracted[v] = 1;
+        rank[v] = order++;
+
+        // v를 남은 그래프에서 떼어내 이후 witness 탐색이 축약된 노드를 훑지 않도록 함
+        neighbors.clear();
+        for (const pair<int, double>& arc : graph.out[v]) {
+            up[v].push_back(arc);
+            removeArc(graph.in[arc.first], v);
+            neighbors.push_back(arc.first);
+        }
+        for (const pair<int, double>& arc : graph.in[v]) {
+            down[v].push_back(arc);
+            removeArc(graph.out[arc.first], v);
+            neighbors.push_back(arc.first);
+        }
+        ArcList().swap(graph.out[v]);
+        ArcList().swap(graph.in[v]);
+        sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(unique(neighbors.begin(), neighbors.end()), neighbors.end());
+
+        for (int u : neighbors) {
+            graph.contractedNeighbors[u]++;
+            graph.level[u] = max(graph.level[u], graph.level[v] + 1);
+        }
+    }
+
+    buildUpwardGraph(up, upOffsets, upTargets, upWeights);
+    buildUpwardGraph(down, downOffsets, downTargets, downWeights);
+
+    forwardDist.assign(nodeCount, 0);
+    backwardDist.assign(nodeCount, 0);
+    forwardStamp.assign(nodeCount, 0);
+    backwardStamp.assign(nodeCount, 0);
+}
+
+void ContractionHierarchy::clear() {
+    nodeCount = 0;
+    shortcutCount = 0;
+    currentStamp = 0;
+    rank.clear();
+    upOffsets.clear();
+    upTargets.clear();
+    upWeights.clear();
+    downOffsets.clear();
+    downTargets.clear();
+    downWeights.clear();
+    forwardDist.clear();
+    backwardDist.clear();
+    forwardStamp.clear();
+    backwardStamp.clear();
+}
+
+double ContractionHierarchy::query(int from, int to) const {
+    if (from == to) return 0;
+
+    currentStamp++;
+    greater<pair<double, int>> heapOrder;
+    forwardHeap.clear();
+    backwardHeap.clear();
+
+    forwardStamp[from] = currentStamp;
+    forwardDist[from] = 0;
+    forwardHeap.push_back({ 0.0, from });
+    backwardStamp[to] = currentStamp;
+    backwardDist[to] = 0;
+    backwardHeap.push_back({ 0.0, to });
+
+    double best = INT_MAX;
+
+    // 한쪽 방향의 최소 거리가 best 이상이 되면 그 방향은 더 볼 필요가 없음
+    auto step = [&](bool forward) {
+        vector<pair<double, int>>& heap = forward ? forwardHeap : backwardHeap;
+        vector<double>& dist = forward ? forwardDist : backwardDist;
+        vector<int>& stamp = forward ? forwardStamp : backwardStamp;
+        const vector<double>& otherDist = forward ? backwardDist : forwardDist;
+        const vector<int>& otherStamp = forward ? backwardStamp : forwardStamp;
+        const vector<int>& edgeOffsets = forward ? upOffsets : downOffsets;
+        const vector<int>& edgeTargets = forward ? upTargets : downTargets;
+        const vector<double>& edgeWeights = forward ? upWeights : downWeights;
+        const vector<int>& stallOffsets = forward ? downOffsets : upOffsets;
+        const vector<int>& stallTargets = forward ? downTargets : upTargets;
+        const vector<double>& stallWeights = forward ? downWeights : upWeights;
+
+        pop_heap(heap.begin(), heap.end(), heapOrder);
+        double d = heap.back().first;
+        int u = heap.back().second;
+        heap.pop_back();
+
+        if (d > dist[u]) return;
+        if (d >= best) {
+            heap.clear();
+            return;
+        }
+        if (otherStamp[u] == currentStamp && d + otherDist[u] < best) {
+            best = d + otherDist[u];
+        }
+
+        // stall-on-demand: 상위 노드를 거쳐 u로 더 짧게 올 수 있으면 u의 거리는 최단이 아니므로 더 퍼뜨리지 않음
+        for (int e = stallOffsets[u]; e < stallOffsets[u + 1]; e++) {
+            int v = stallTargets[e];
+            if (stamp[v] == currentStamp && dist[v] + stallWeights[e] < d) return;
+        }
+
+        for (int e = edgeOffsets[u]; e < edgeOffsets[u + 1]; e++) {
+            int v = edgeTargets[e];
+            double cost = d + edgeWeights[e];
+            if (stamp[v] != currentStamp || cost < dist[v]) {
+                stamp[v] = currentStamp;
+                dist[v] = cost;
+                heap.push_back({ cost, v });
+                push_heap(heap.begin(), heap.end(), heapOrder);
+            }
+        }
+    };
+
+    while (!forwardHeap.empty() || !backwardHeap.empty()) {
+        if (!forwardHeap.empty()) step(true);
+        if (!backwardHeap.empty()) step(false);
+    }
+
+    return best;
+}
+
+void ContractionHierarchy::manyToMany(const vector<int>& sources, const vector<int>& targets, double* out, ThreadPool* pool) const {
+    int sourceCount = sources.size();
+    int targetCount = targets.size();
+    for (int i = 0; i < sourceCount; i++) {
+        for (int j = 0; j < targetCount; j++) {
+            out[(size_t)i * targetCount + j] = sources[i] == targets[j] ? 0 : INT_MAX;
+        }
+    }
+    if (nodeCount == 0 || sourceCount == 0 || targetCount == 0) return;
+
+    int workers = pool != nullptr ? pool->getThreadCount() : 1;
+    vector<UpwardSearch> searches(workers);
+    for (UpwardSearch& search : searches) {
+        search.dist.resize(nodeCount);
+        search.stamp.assign(nodeCount, 0);
+    }
+    auto forEach = [&](int count, const function<void(int, int)>& task) {
+        if (pool != nullptr) pool->parallelFor(count, task);
+        else {
+            for (int index = 0; index < count; index++) task(0, index);
+        }
+    };
+
+    //1) 목적지별 역방향 탐색. 결과를 노드별 bucket(CSR)으로 모음 (한 bucket 안은 목적지 순서)
+    vector<vector<pair<int, double>>> reached(targetCount);
+    forEach(targetCount, [&](int worker, int j) {
+        int target = targets[j];
+        if (target < 0 || target >= nodeCount) return;
+        UpwardSearch& search = searches[worker];
+        search.run(target, downOffsets, downTargets, downWeights, upOffsets, upTargets, upWeights);
+        reached[j] = search.settled;
+    });
+
+    vector<int> bucketOffsets(nodeCount + 1, 0);
+    for (const vector<pair<int, double>>& list : reached) {
+        for (const pair<int, double>& entry : list) bucketOffsets[entry.first + 1]++;
+    }
+    for (int v = 0; v < nodeCount; v++) bucketOffsets[v + 1] += bucketOffsets[v];
+    vector<pair<int, double>> buckets(bucketOffsets.back());   // (목적지 번호 j, 노드에서 목적지까지 거리)
+    vector<int> cursor(bucketOffsets.begin(), bucketOffsets.end() - 1);
+    for (int j = 0; j < targetCount; j++) {
+        for (const pair<int, double>& entry : reached[j]) buckets[cursor[entry.first]++] = { j, entry.second };
+        vector<pair<int, double>>().swap(reached[j]);
+    }
+
+    //2) 출발점별 정방향 탐색. 확정한 노드의 bucket을 훑어 행 i를 채움 (행마다 한 스레드라 결과가 스레드 수와 무관)
+    forEach(sourceCount, [&](int worker, int i) {
+        int source = sources[i];
+        if (source < 0 || source >= nodeCount) return;
+        UpwardSearch& search = searches[worker];
+        search.run(source, upOffsets, upTargets, upWeights, downOffsets, downTargets, downWeights);
+        double* row = out + (size_t)i * targetCount;
+        for (const pair<int, double>& node : search.settled) {
+            for (int b = bucketOffsets[node.first]; b < bucketOffsets[node.first + 1]; b++) {
+                double cost = node.second + buckets[b].second;
+                if (cost < row[buckets[b].first]) row[buckets[b].first] = cost;
+            }
+        }
+    });
+}
+
+bool ContractionHierarchy::isBuilt() const {
+    return nodeCount > 0;
+}
+
+int ContractionHierarchy::getNodeCount() const {
+    return nodeCount;
+}
+
+int ContractionHierarchy::getShortcutCount() const {
+    return shortcutCount;
+}
+
+size_t ContractionHierarchy::memoryBytes() const {
+    return (rank.size() + upOffsets.size() + upTargets.size() + downOffsets.size() + downTargets.size()
+            + forwardStamp.size() + backwardStamp.size()) * sizeof(int)
+         + (upWeights.size() + downWeights.size() + forwardDist.size() + backwardDist.size()) * sizeof(double);
+}
@@ -0,0 +1,58 @@
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include "thread_pool.h"
+
+using namespace std;
+
+// 도로 그래프의 Contraction Hierarchy
+// 중요도가 낮은 노드부터 축약하면서 최단경로를 보존하는 shortcut 간선을 추가해두고,
+// 질의는 순위가 올라가는 간선만 따라가는 양방향 다익스트라로 처리한다. (NxN 테이블 없음)
+class ContractionHierarchy {
+public:
+    ContractionHierarchy();
+
+    // CSR 도로 그래프로 전처리 (노드 u의 간선은 targets/weights의 [offsets[u], offsets[u+1]) 구간)
+    void build(int nodeCount, const vector<int>& offsets, const vector<int>& targets, const vector<double>& weights);
+    void clear();
+
+    double query(int from, int to) const;   // from에서 to까지 최단거리. 길이없으면 INT_MAX 반환
+    // sources x targets 최단거리를 out[i * targets.size() + j]에 기록 (bucket 방식 many-to-many).
+    // 목적지마다 역방향 상향 탐색을 한 번씩 해서 만나는 노드에 (목적지, 거리)를 걸어두고,
+    // 출발점마다 정방향 상향 탐색을 한 번씩 하면서 걸려 있는 값과 더한다. 질의 S*T번 대신 탐색 S+T번
+    void manyToMany(const vector<int>& sources, const vector<int>& targets, double* out, ThreadPool* pool = nullptr) const;
+
+    // Getters
+    bool isBuilt() const;
+    int getNodeCount() const;
+    int getShortcutCount() const;
+    size_t memoryBytes() const;             // 질의에 쓰이는 배열들이 차지하는 메모리
+
+private:
+    int nodeCount;
+    int shortcutCount;
+    vector<int> rank;                       // 축약 순서 (클수록 중요한 노드)
+
+    // 상향 그래프 (CSR). up은 정방향 탐색용 u->v (rank[v] > rank[u]),
+    // down은 역방향 탐색용으로 원래 간선 v->u (rank[v] > rank[u])를 u에서 v로 뒤집어 저장
+    vector<int> upOffsets;
+    vector<int> upTargets;
+    vector<double> upWeights;
+    vector<int> downOffsets;
+    vector<int> downTargets;
+    vector<double> downWeights;
+
+    // 질의용 작업 공간. 스탬프로 초기화를 대신해 질의마다 O(N) 초기화나 재할당을 하지 않음
+    mutable vector<double> forwardDist;
+    mutable vector<double> backwardDist;
+    mutable vector<int> forwardStamp;
+    mutable vector<int> backwardStamp;
+    mutable vector<pair<double, int>> forwardHeap;
+    mutable vector<pair<double, int>> backwardHeap;
+    mutable int currentStamp;
+};
+
+#endif
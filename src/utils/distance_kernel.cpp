@@ -0,0 +1,149 @@
+#include "distance_kernel.h"
+#include <cmath>
+#include <atomic>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DISTANCE_KERNEL_X86 1
+#endif
+
+PointArrays::PointArrays(const vector<Location>& locations) {
+    reserve(locations.size());
+    for (const Location& location : locations) {
+        add(location);
+    }
+}
+
+void PointArrays::reserve(size_t count) {
+    x.reserve(count);
+    y.reserve(count);
+}
+
+void PointArrays::add(const Location& location) {
+    x.push_back(location.getX());
+    y.push_back(location.getY());
+}
+
+namespace {
+
+// 커널 하나: out[i] = |(ax[i], ay[i]) - (bx[i], by[i])|. a 쪽 간격이 0이면 한 점에서 여러 점까지 (oneToMany)
+typedef void (*DistanceFunction)(const double* ax, const double* ay, int aStep, const double* bx, const double* by, int count, double* out);
+
+void distancesScalar(const double* ax, const double* ay, int aStep, const double* bx, const double* by, int count, double* out) {
+    for (int i = 0; i < count; i++) {
+        double dx = bx[i] - ax[i * aStep];
+        double dy = by[i] - ay[i * aStep];
+        out[i] = sqrt(dx * dx + dy * dy);
+    }
+}
+
+#ifdef DISTANCE_KERNEL_X86
+// FMA로 합치지 않도록 곱셈과 덧셈을 따로 둠 (스칼라 경로와 같은 반올림)
+__attribute__((target("sse2")))
+inline __m128d distance2(__m128d x, __m128d y, const double* bx, const double* by) {
+    __m128d dx = _mm_sub_pd(_mm_loadu_pd(bx), x);
+    __m128d dy = _mm_sub_pd(_mm_loadu_pd(by), y);
+    return _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)));
+}
+
+__attribute__((target("sse2")))
+void distancesSse2(const double* ax, const double* ay, int aStep, const double* bx, const double* by, int count, double* out) {
+    int i = 0;
+    if (aStep == 0) {
+        __m128d x = _mm_set1_pd(ax[0]);
+        __m128d y = _mm_set1_pd(ay[0]);
+        for (; i + 2 <= count; i += 2) _mm_storeu_pd(out + i, distance2(x, y, bx + i, by + i));
+    }
+    else {
+        for (; i + 2 <= count; i += 2) _mm_storeu_pd(out + i, distance2(_mm_loadu_pd(ax + i), _mm_loadu_pd(ay + i), bx + i, by + i));
+    }
+    distancesScalar(ax + i * aStep, ay + i * aStep, aStep, bx + i, by + i, count - i, out + i);
+}
+
+__attribute__((target("avx2")))
+inline __m256d distance4(__m256d x, __m256d y, const double* bx, const double* by) {
+    __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(bx), x);
+    __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(by), y);
+    return _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+}
+
+__attribute__((target("avx2")))
+void distancesAvx2(const double* ax, const double* ay, int aStep, const double* bx, const double* by, int count, double* out) {
+    int i = 0;
+    if (aStep == 0) {
+        __m256d x = _mm256_set1_pd(ax[0]);
+        __m256d y = _mm256_set1_pd(ay[0]);
+        for (; i + 4 <= count; i += 4) _mm256_storeu_pd(out + i, distance4(x, y, bx + i, by + i));
+    }
+    else {
+        for (; i + 4 <= count; i += 4) _mm256_storeu_pd(out + i, distance4(_mm256_loadu_pd(ax + i), _mm256_loadu_pd(ay + i), bx + i, by + i));
+    }
+    distancesScalar(ax + i * aStep, ay + i * aStep, aStep, bx + i, by + i, count - i, out + i);
+}
+#endif
+
+DistanceKernelLevel detectLevel() {
+#ifdef DISTANCE_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return DISTANCE_KERNEL_AVX2;
+    if (__builtin_cpu_supports("sse2")) return DISTANCE_KERNEL_SSE2;
+#endif
+    return DISTANCE_KERNEL_SCALAR;
+}
+
+atomic<int>& currentLevel() {
+    static atomic<int> level(detectLevel());
+    return level;
+}
+
+DistanceFunction kernelFor(DistanceKernelLevel level) {
+#ifdef DISTANCE_KERNEL_X86
+    if (level == DISTANCE_KERNEL_AVX2) return distancesAvx2;
+    if (level == DISTANCE_KERNEL_SSE2) return distancesSse2;
+#endif
+    (void)level;
+    return distancesScalar;
+}
+
+}
+
+void DistanceKernel::oneToMany(const Location& from, const PointArrays& targets, double* out) {
+    double x = from.getX();
+    double y = from.getY();
+    kernelFor(getLevel())(&x, &y, 0, targets.x.data(), targets.y.data(), targets.size(), out);
+}
+
+void DistanceKernel::manyToMany(const PointArrays& sources, const PointArrays& targets, double* out) {
+    DistanceFunction kernel = kernelFor(getLevel());
+    int cols = targets.size();
+    for (int i = 0; i < sources.size(); i++) {
+        kernel(&sources.x[i], &sources.y[i], 0, targets.x.data(), targets.y.data(), cols, out + (size_t)i * cols);
+    }
+}
+
+void DistanceKernel::pairwise(const PointArrays& from, const PointArrays& to, double* out) {
+    int count = min(from.size(), to.size());
+    kernelFor(getLevel())(from.x.data(), from.y.data(), 1, to.x.data(), to.y.data(), count, out);
+}
+
+DistanceKernelLevel DistanceKernel::getLevel() {
+    return (DistanceKernelLevel)currentLevel().load(memory_order_relaxed);
+}
+
+DistanceKernelLevel DistanceKernel::getSupportedLevel() {
+    static const DistanceKernelLevel supported = detectLevel();
+    return supported;
+}
+
+void DistanceKernel::setLevel(DistanceKernelLevel level) {
+    currentLevel().store(min(level, getSupportedLevel()), memory_order_relaxed);
+}
+
+const char* DistanceKernel::levelName(DistanceKernelLevel level) {
+    switch (level) {
+    case DISTANCE_KERNEL_AVX2: return "avx2";
+    case DISTANCE_KERNEL_SSE2: return "sse2";
+    default: return "scalar";
+    }
+}
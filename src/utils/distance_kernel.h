@@ -0,0 +1,42 @@
+#ifndef DISTANCE_KERNEL_H
+#define DISTANCE_KERNEL_H
+
+#include <vector>
+#include "location.h"
+
+using namespace std;
+
+// 좌표를 x, y 배열로 따로 모은 점 집합 (SoA). 거리 커널이 두 배열을 연속으로 읽어 한 번에 여러 점을 계산한다
+struct PointArrays {
+    vector<double> x;
+    vector<double> y;
+
+    PointArrays() {}
+    explicit PointArrays(const vector<Location>& locations);
+    void reserve(size_t count);
+    void add(const Location& location);
+    int size() const { return x.size(); }
+};
+
+// 직선거리 일괄 계산에 쓰는 명령어 수준
+enum DistanceKernelLevel {
+    DISTANCE_KERNEL_SCALAR,   // 한 번에 1개
+    DISTANCE_KERNEL_SSE2,     // 한 번에 2개 (x86-64 기본)
+    DISTANCE_KERNEL_AVX2      // 한 번에 4개
+};
+
+// 직선거리 일괄 계산. 실행 중인 CPU가 지원하는 가장 넓은 커널을 처음 쓸 때 골라 이후 계속 쓴다 (빌드 옵션과 무관).
+// 결과는 Location::calculateDistance와 비트 단위로 같다 (정수 좌표 차의 제곱합은 double로 정확하고 sqrt는 올바르게 반올림됨)
+class DistanceKernel {
+public:
+    static void oneToMany(const Location& from, const PointArrays& targets, double* out);   // out[j] = from -> targets[j]
+    static void manyToMany(const PointArrays& sources, const PointArrays& targets, double* out);   // out[i * targets.size() + j]
+    static void pairwise(const PointArrays& from, const PointArrays& to, double* out);   // out[i] = from[i] -> to[i] (크기가 같아야 함)
+
+    static DistanceKernelLevel getLevel();
+    static DistanceKernelLevel getSupportedLevel();
+    static void setLevel(DistanceKernelLevel level);   // 비교 측정용. 지원하지 않는 수준이면 지원하는 최고 수준으로 낮춤
+    static const char* levelName(DistanceKernelLevel level);
+};
+
+#endif
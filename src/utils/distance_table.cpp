@@ -0,0 +1,158 @@
+#include "distance_table.h"
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <new>
+
+DistanceTable::DistanceTable()
+    : data(nullptr), owned(true), tableSize(0), capacity(0), storage(DISTANCE_DOUBLE), scale(1.0), saturatedCount(0) {}
+
+DistanceTable::~DistanceTable() {
+    clear();
+}
+
+void DistanceTable::setStorage(DistanceStorage storage_in, double scale_in) {
+    clear();
+    storage = storage_in;
+    scale = scale_in > 0 ? scale_in : 1.0;
+}
+
+void DistanceTable::reset(int size) {
+    clear();
+    if (size <= 0) return;
+
+    capacity = paddedCapacity(size);
+    data = allocate(capacity);
+    tableSize = size;
+    fillUnreachable(data, capacity, 0, tableSize, 0, tableSize);
+    for (int i = 0; i < tableSize; i++) {
+        set(i, i, 0);
+    }
+}
+
+void DistanceTable::resize(int newSize) {
+    if (newSize <= tableSize) return;
+    if (!owned) detach();
+    if (data == nullptr) {
+        reset(newSize);
+        return;
+    }
+
+    if (newSize > capacity) {   // 용량을 두 배로 늘려 새 버퍼로 행을 옮김
+        int newCapacity = paddedCapacity(max(newSize, capacity * 2));
+        unsigned char* grown = allocate(newCapacity);
+        size_t rowBytes = (size_t)tableSize * elementSize();
+        for (int i = 0; i < tableSize; i++) {
+            memcpy(grown + (size_t)i * newCapacity * elementSize(), data + (size_t)i * capacity * elementSize(), rowBytes);
+        }
+        free(data);
+        data = grown;
+        capacity = newCapacity;
+    }
+
+    fillUnreachable(data, capacity, 0, tableSize, tableSize, newSize);
+    fillUnreachable(data, capacity, tableSize, newSize, 0, newSize);
+    int oldSize = tableSize;
+    tableSize = newSize;
+    for (int i = oldSize; i < newSize; i++) {
+        set(i, i, 0);
+    }
+}
+
+void DistanceTable::clear() {
+    if (owned) free(data);
+    data = nullptr;
+    owned = true;
+    tableSize = 0;
+    capacity = 0;
+    saturatedCount = 0;
+}
+
+void DistanceTable::setRow(int from, const double* values) {
+    for (int to = 0; to < tableSize; to++) {
+        set(from, to, values[to]);
+    }
+}
+
+void DistanceTable::permute(const vector<int>& order) {
+    if (data == nullptr || (int)order.size() != tableSize) return;
+
+    unsigned char* permuted = allocate(capacity);   //attach 상태여도 원본은 건드리지 않고 새 버퍼에 모음
+    switch (storage) {
+    case DISTANCE_FLOAT: gatherRows<float>(permuted, order); break;
+    case DISTANCE_UINT16: gatherRows<uint16_t>(permuted, order); break;
+    default: gatherRows<double>(permuted, order);
+    }
+    if (owned) free(data);
+    data = permuted;
+    owned = true;
+}
+
+template <typename T>
+void DistanceTable::gatherRows(unsigned char* target, const vector<int>& order) const {
+    for (int i = 0; i < tableSize; i++) {
+        const T* source = reinterpret_cast<const T*>(data + (size_t)order[i] * rowBytes());
+        T* row = reinterpret_cast<T*>(target + (size_t)i * rowBytes());
+        for (int j = 0; j < tableSize; j++) {
+            row[j] = source[order[j]];
+        }
+    }
+}
+
+void DistanceTable::attach(const unsigned char* buffer, int size, int rowCapacity) {
+    clear();
+    data = const_cast<unsigned char*>(buffer);   //owned가 false인 동안은 읽기만 함
+    owned = false;
+    tableSize = size;
+    capacity = rowCapacity;
+}
+
+void DistanceTable::detach() {
+    if (owned) return;
+    unsigned char* copied = allocate(capacity);
+    memcpy(copied, data, (size_t)tableSize * rowBytes());
+    data = copied;
+    owned = true;
+}
+
+size_t DistanceTable::memoryBytes() const {
+    if (!owned) return 0;
+    return (size_t)capacity * capacity * elementSize();
+}
+
+size_t DistanceTable::elementSize() const {
+    switch (storage) {
+    case DISTANCE_FLOAT: return sizeof(float);
+    case DISTANCE_UINT16: return sizeof(uint16_t);
+    default: return sizeof(double);
+    }
+}
+
+int DistanceTable::paddedCapacity(int count) const {   // 행 시작이 항상 캐시 라인 경계에 오도록 원소 수를 올림
+    int perLine = CACHE_LINE / elementSize();
+    return (count + perLine - 1) / perLine * perLine;
+}
+
+unsigned char* DistanceTable::allocate(int rowCapacity) const {
+    size_t bytes = (size_t)rowCapacity * rowCapacity * elementSize();
+    bytes = (bytes + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    unsigned char* buffer = static_cast<unsigned char*>(aligned_alloc(CACHE_LINE, bytes));
+    if (buffer == nullptr) throw bad_alloc();
+    return buffer;
+}
+
+void DistanceTable::fillUnreachable(unsigned char* buffer, int rowCapacity, int rowBegin, int rowEnd, int colBegin, int colEnd) {
+    for (int i = rowBegin; i < rowEnd; i++) {
+        unsigned char* row = buffer + (size_t)i * rowCapacity * elementSize();
+        switch (storage) {
+        case DISTANCE_FLOAT:
+            fill(reinterpret_cast<float*>(row) + colBegin, reinterpret_cast<float*>(row) + colEnd, (float)INT_MAX);
+            break;
+        case DISTANCE_UINT16:
+            fill(reinterpret_cast<uint16_t*>(row) + colBegin, reinterpret_cast<uint16_t*>(row) + colEnd, UINT16_UNREACHABLE);
+            break;
+        default:
+            fill(reinterpret_cast<double*>(row) + colBegin, reinterpret_cast<double*>(row) + colEnd, (double)INT_MAX);
+        }
+    }
+}
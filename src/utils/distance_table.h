@@ -0,0 +1,117 @@
+#ifndef DISTANCE_TABLE_H
+#define DISTANCE_TABLE_H
+
+#include <climits>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <atomic>
+#include <vector>
+
+using namespace std;
+
+// 거리 테이블 원소 저장 형식
+enum DistanceStorage {
+    DISTANCE_DOUBLE,    // 8바이트, 원래 값 그대로
+    DISTANCE_FLOAT,     // 4바이트, 유효숫자 약 7자리
+    DISTANCE_UINT16     // 2바이트 고정소수점 (값 = 저장값 * scale), 65534 * scale 넘는 거리는 포화
+};
+
+// NxN 최단거리 테이블. 한 번의 64바이트 정렬 할당에 행을 이어 붙여 저장한다.
+// 행 간격(stride)은 캐시 라인 배수로 맞추고, 노드가 늘어나면 용량을 두 배씩 늘린다.
+// 도달 불가는 INT_MAX로 읽힌다.
+// attach()로 외부의 읽기 전용 버퍼(매핑된 캐시 파일)를 복사 없이 쓸 수 있고, 값을 바꾸는 순간 자기 버퍼로 복사한다.
+class DistanceTable {
+public:
+    DistanceTable();
+    ~DistanceTable();
+
+    DistanceTable(const DistanceTable&) = delete;
+    DistanceTable& operator=(const DistanceTable&) = delete;
+
+    void setStorage(DistanceStorage storage, double scale);   // 형식을 바꾸면 기존 값은 비워짐
+    void reset(int size);       // size x size, 대각선 0 / 나머지 도달 불가로 초기화
+    void resize(int newSize);   // 기존 값 유지, 새 행/열은 도달 불가
+    void clear();
+
+    inline double get(int from, int to) const;
+    inline void set(int from, int to, double value);
+    void setRow(int from, const double* values);   // values[0..size) 를 from 행에 기록
+    void permute(const vector<int>& order);        // 새 (i, j) = 기존 (order[i], order[j]). 저장값을 그대로 옮김
+
+    // buffer에 size개 행이 rowCapacity 간격으로 현재 형식 그대로 들어있어야 함 (buffer는 detach/clear 전까지 유지)
+    void attach(const unsigned char* buffer, int size, int rowCapacity);
+    const unsigned char* rowData(int from) const { return data + (size_t)from * rowBytes(); }
+    size_t rowBytes() const { return (size_t)capacity * elementSize(); }
+
+    // Getters
+    int size() const { return tableSize; }
+    int getCapacity() const { return capacity; }
+    bool isAttached() const { return data != nullptr && !owned; }
+    void detach();   // attach한 외부 버퍼 내용을 자기 버퍼로 복사 (여러 스레드가 행을 쓰기 전에 미리 호출)
+    DistanceStorage getStorage() const { return storage; }
+    double getScale() const { return scale; }
+    size_t memoryBytes() const;   // 자기 버퍼 크기 = capacity x capacity 원소 (attach한 외부 버퍼는 제외)
+    long long getSaturatedCount() const { return saturatedCount.load(); }   // uint16 범위를 넘어 잘린 값 수
+
+private:
+    static constexpr int CACHE_LINE = 64;
+    static constexpr uint16_t UINT16_UNREACHABLE = 65535;
+
+    unsigned char* data;
+    bool owned;                 // false면 data는 attach한 외부 버퍼
+    int tableSize;
+    int capacity;               // 한 행에 들어가는 원소 수 (stride)
+    DistanceStorage storage;
+    double scale;
+    atomic<long long> saturatedCount;   // 여러 스레드가 서로 다른 행을 채울 수 있으므로 원자적으로 셈
+
+    size_t elementSize() const;
+    int paddedCapacity(int count) const;
+    unsigned char* allocate(int rowCapacity) const;
+    template <typename T> void gatherRows(unsigned char* target, const vector<int>& order) const;
+    void fillUnreachable(unsigned char* buffer, int rowCapacity, int rowBegin, int rowEnd, int colBegin, int colEnd);
+};
+
+inline double DistanceTable::get(int from, int to) const {
+    size_t index = (size_t)from * capacity + to;
+    switch (storage) {
+    case DISTANCE_FLOAT: {
+        float value = reinterpret_cast<const float*>(data)[index];
+        return value >= (float)INT_MAX ? INT_MAX : value;
+    }
+    case DISTANCE_UINT16: {
+        uint16_t value = reinterpret_cast<const uint16_t*>(data)[index];
+        return value == UINT16_UNREACHABLE ? INT_MAX : value * scale;
+    }
+    default:
+        return reinterpret_cast<const double*>(data)[index];
+    }
+}
+
+inline void DistanceTable::set(int from, int to, double value) {
+    if (!owned) detach();
+    size_t index = (size_t)from * capacity + to;
+    switch (storage) {
+    case DISTANCE_FLOAT:
+        reinterpret_cast<float*>(data)[index] = value >= INT_MAX ? (float)INT_MAX : (float)value;
+        break;
+    case DISTANCE_UINT16: {
+        uint16_t stored = UINT16_UNREACHABLE;
+        if (value < INT_MAX) {
+            double units = llround(value / scale);
+            if (units >= UINT16_UNREACHABLE) {
+                units = UINT16_UNREACHABLE - 1;
+                saturatedCount++;
+            }
+            stored = (uint16_t)units;
+        }
+        reinterpret_cast<uint16_t*>(data)[index] = stored;
+        break;
+    }
+    default:
+        reinterpret_cast<double*>(data)[index] = value;
+    }
+}
+
+#endif
@@ -0,0 +1,94 @@
+#include "floyd_warshall.h"
+#include <climits>
+#include <cstdlib>
+#include <algorithm>
+#include <new>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+FloydWarshallMatrix::FloydWarshallMatrix(int size) : data(nullptr), nodeCount(size), stride(0) {
+    stride = (size + BLOCK - 1) / BLOCK * BLOCK;
+    if (stride == 0) return;
+
+    data = static_cast<double*>(aligned_alloc(64, memoryBytes()));   //stride가 BLOCK 배수라 크기도 64바이트 배수
+    if (data == nullptr) throw bad_alloc();
+
+    fill(data, data + (size_t)stride * stride, (double)INT_MAX);
+    for (int i = 0; i < stride; i++) {
+        data[(size_t)i * stride + i] = 0;
+    }
+}
+
+FloydWarshallMatrix::~FloydWarshallMatrix() {
+    free(data);
+}
+
+void FloydWarshallMatrix::relax(int from, int to, double value) {
+    double& current = data[(size_t)from * stride + to];
+    if (value < current) current = value;
+}
+
+void FloydWarshallMatrix::solve(ThreadPool* pool) {
+    int blocks = stride / BLOCK;
+    auto runAll = [&](int count, const function<void(int, int)>& task) {
+        if (pool != nullptr) {
+            pool->parallelFor(count, task);
+            return;
+        }
+        for (int index = 0; index < count; index++) {
+            task(0, index);
+        }
+    };
+
+    for (int kb = 0; kb < blocks; kb++) {
+        int k0 = kb * BLOCK;
+
+        // 1단계: 대각 블록 (kb, kb)
+        relaxBlock(k0, k0, k0);
+
+        // 2단계: kb 행의 블록과 kb 열의 블록 (대각 블록만 읽으므로 서로 독립)
+        runAll(2 * blocks, [&](int, int index) {
+            int other = index / 2;
+            if (other == kb) return;
+            if (index % 2 == 0) relaxBlock(k0, other * BLOCK, k0);
+            else relaxBlock(other * BLOCK, k0, k0);
+        });
+
+        // 3단계: 나머지 블록 (2단계 결과만 읽으므로 서로 독립)
+        runAll(blocks * blocks, [&](int, int index) {
+            int ib = index / blocks;
+            int jb = index % blocks;
+            if (ib == kb || jb == kb) return;
+            relaxBlock(ib * BLOCK, jb * BLOCK, k0);
+        });
+    }
+}
+
+void FloydWarshallMatrix::relaxBlock(int ib, int jb, int kb) {
+    //k를 가장 바깥에 두면 (ib, jb)가 kb 행/열 블록과 겹쳐도 일반 Floyd–Warshall과 같은 결과
+    //k행 조각은 지역 버퍼로 복사해 두어 out과 겹치지 않음을 컴파일러가 알게 함 (AVX2 없이도 자동 벡터화)
+    alignas(64) double rowK[BLOCK];
+    for (int k = kb; k < kb + BLOCK; k++) {
+        const double* pivot = data + (size_t)k * stride + jb;
+        copy(pivot, pivot + BLOCK, rowK);
+        for (int i = ib; i < ib + BLOCK; i++) {
+            double* rowI = data + (size_t)i * stride;
+            double viaK = rowI[k];
+            if (viaK >= INT_MAX) continue;   //i에서 k로 못 가면 갱신될 칸이 없음
+
+            double* out = rowI + jb;
+#ifdef __AVX2__
+            __m256d base = _mm256_set1_pd(viaK);
+            for (int j = 0; j < BLOCK; j += 4) {
+                __m256d candidate = _mm256_add_pd(base, _mm256_load_pd(rowK + j));
+                _mm256_store_pd(out + j, _mm256_min_pd(_mm256_load_pd(out + j), candidate));
+            }
+#else
+            for (int j = 0; j < BLOCK; j++) {
+                out[j] = min(out[j], viaK + rowK[j]);
+            }
+#endif
+        }
+    }
+}
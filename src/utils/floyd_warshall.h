@@ -0,0 +1,38 @@
+#ifndef FLOYD_WARSHALL_H
+#define FLOYD_WARSHALL_H
+
+#include <cstddef>
+#include "thread_pool.h"
+
+using namespace std;
+
+// 블록 단위(cache-blocked) Floyd–Warshall 용 NxN 거리 행렬.
+// 크기를 BLOCK 배수로 올린 하나의 64바이트 정렬 버퍼에 행을 이어 저장하고, 남는 칸은 도달 불가(INT_MAX)로 둔다.
+// solve()는 BLOCK x BLOCK 블록 단위로 min-plus 갱신을 하며 (AVX2로 빌드하면 4개씩 벡터 연산),
+// 대각 블록 -> 같은 행/열 블록 -> 나머지 블록 순서로 진행하고 같은 단계의 블록은 스레드 풀에서 나눠 처리한다.
+class FloydWarshallMatrix {
+public:
+    static constexpr int BLOCK = 64;
+
+    explicit FloydWarshallMatrix(int size);   // 대각선 0 / 나머지 도달 불가
+    ~FloydWarshallMatrix();
+
+    FloydWarshallMatrix(const FloydWarshallMatrix&) = delete;
+    FloydWarshallMatrix& operator=(const FloydWarshallMatrix&) = delete;
+
+    void relax(int from, int to, double value);   // 간선 하나 반영 (더 짧을 때만)
+    void solve(ThreadPool* pool);                 // pool이 nullptr이면 단일 스레드
+
+    const double* row(int from) const { return data + (size_t)from * stride; }   // row(from)[to] : from -> to 최단거리
+    int size() const { return nodeCount; }
+    size_t memoryBytes() const { return (size_t)stride * stride * sizeof(double); }
+
+private:
+    double* data;
+    int nodeCount;
+    int stride;   // BLOCK 배수로 올린 크기
+
+    void relaxBlock(int ib, int jb, int kb);   // (ib, jb) 블록을 kb 블록을 경유하는 경로로 갱신
+};
+
+#endif
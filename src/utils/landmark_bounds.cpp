@@ -0,0 +1,162 @@
+#include "landmark_bounds.h"
+#include <climits>
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+namespace {
+
+// 한 출발점에서 모든 노드까지 최단거리 (도달 불가는 INT_MAX)
+void shortestDistances(int source, int nodeCount, const vector<int>& offsets, const vector<int>& targets,
+                       const vector<double>& weights, vector<double>& dist, vector<pair<double, int>>& heap) {
+    greater<pair<double, int>> heapOrder;
+    dist.assign(nodeCount, INT_MAX);
+    dist[source] = 0;
+    heap.clear();
+    heap.push_back({ 0.0, source });
+
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), heapOrder);
+        double d = heap.back().first;
+        int u = heap.back().second;
+        heap.pop_back();
+        if (d > dist[u]) continue;
+
+        for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+            if (weights[e] >= INT_MAX) continue;
+            int v = targets[e];
+            double cost = d + weights[e];
+            if (cost < dist[v]) {
+                dist[v] = cost;
+                heap.push_back({ cost, v });
+                push_heap(heap.begin(), heap.end(), heapOrder);
+            }
+        }
+    }
+}
+
+// 거리 합산 순서 차이로 생기는 반올림 오차만큼 하한을 낮춤 (하한이 실제 최단거리를 넘지 않도록)
+const double BOUND_ROUNDING_SLACK = 1e-9;
+
+}
+
+LandmarkBounds::LandmarkBounds() : nodeCount(0) {}
+
+void LandmarkBounds::build(int count, const vector<int>& offsets, const vector<int>& targets, const vector<double>& weights,
+                           int landmarkCount, ThreadPool* pool) {
+    clear();
+    if (count <= 0 || landmarkCount <= 0) return;
+    nodeCount = count;
+    int k = min(landmarkCount, nodeCount);
+
+    //랜드마크 선택: 노드 0에서 가장 먼 노드부터 시작해, 고른 랜드마크들까지의 거리가 가장 먼 노드를 차례로 추가.
+    //어느 랜드마크에서도 닿지 않는 노드가 가장 먼 것으로 취급되므로 연결되지 않은 구역에도 랜드마크가 놓인다
+    vector<double> dist;
+    vector<pair<double, int>> heap;
+    vector<vector<double>> forward;
+    vector<double> nearest(nodeCount, INT_MAX);
+    shortestDistances(0, nodeCount, offsets, targets, weights, dist, heap);
+    int next = 0;
+    for (int v = 0; v < nodeCount; v++) {
+        if (dist[v] < INT_MAX && dist[v] > dist[next]) next = v;
+    }
+    while ((int)landmarks.size() < k) {
+        landmarks.push_back(next);
+        shortestDistances(next, nodeCount, offsets, targets, weights, dist, heap);
+        forward.push_back(dist);
+
+        next = -1;
+        for (int v = 0; v < nodeCount; v++) {
+            nearest[v] = min(nearest[v], dist[v]);
+            if (nearest[v] > 0 && (next < 0 || nearest[v] > nearest[next])) next = v;
+        }
+        if (next < 0) break;   //모든 노드가 이미 랜드마크
+    }
+    k = landmarks.size();
+
+    //랜드마크까지의 거리는 간선을 뒤집은 그래프에서 랜드마크를 출발점으로 계산
+    vector<int> reverseOffsets(nodeCount + 1, 0);
+    for (int u = 0; u < nodeCount; u++) {
+        for (int e = offsets[u]; e < offsets[u + 1]; e++) reverseOffsets[targets[e] + 1]++;
+    }
+    for (int v = 0; v < nodeCount; v++) reverseOffsets[v + 1] += reverseOffsets[v];
+    vector<int> reverseTargets(reverseOffsets.back());
+    vector<double> reverseWeights(reverseOffsets.back());
+    vector<int> cursor(reverseOffsets.begin(), reverseOffsets.end() - 1);
+    for (int u = 0; u < nodeCount; u++) {
+        for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+            int position = cursor[targets[e]]++;
+            reverseTargets[position] = u;
+            reverseWeights[position] = weights[e];
+        }
+    }
+
+    fromLandmark.assign((size_t)nodeCount * k, INT_MAX);
+    toLandmark.assign((size_t)nodeCount * k, INT_MAX);
+    auto storeRow = [&](int l) {
+        vector<double> backward;
+        vector<pair<double, int>> backwardHeap;
+        shortestDistances(landmarks[l], nodeCount, reverseOffsets, reverseTargets, reverseWeights, backward, backwardHeap);
+        for (int v = 0; v < nodeCount; v++) {
+            fromLandmark[(size_t)v * k + l] = forward[l][v];
+            toLandmark[(size_t)v * k + l] = backward[v];
+        }
+    };
+    if (pool != nullptr) pool->parallelFor(k, [&](int, int l) { storeRow(l); });
+    else {
+        for (int l = 0; l < k; l++) storeRow(l);
+    }
+}
+
+void LandmarkBounds::clear() {
+    nodeCount = 0;
+    landmarks.clear();
+    fromLandmark.clear();
+    toLandmark.clear();
+    fromLandmark.shrink_to_fit();
+    toLandmark.shrink_to_fit();
+}
+
+double LandmarkBounds::lowerBound(int from, int to) const {
+    if (from == to) return 0;
+    if (from < 0 || to < 0 || from >= nodeCount || to >= nodeCount) return 0;
+
+    int k = landmarks.size();
+    const double* fromU = &fromLandmark[(size_t)from * k];
+    const double* fromV = &fromLandmark[(size_t)to * k];
+    const double* toU = &toLandmark[(size_t)from * k];
+    const double* toV = &toLandmark[(size_t)to * k];
+
+    double bound = 0;
+    for (int l = 0; l < k; l++) {
+        if (fromU[l] < INT_MAX) {   // d(L, to) <= d(L, from) + d(from, to)
+            if (fromV[l] >= INT_MAX) return INT_MAX;
+            bound = max(bound, fromV[l] - fromU[l] - BOUND_ROUNDING_SLACK * fromV[l]);
+        }
+        if (toV[l] < INT_MAX) {     // d(from, L) <= d(from, to) + d(to, L)
+            if (toU[l] >= INT_MAX) return INT_MAX;
+            bound = max(bound, toU[l] - toV[l] - BOUND_ROUNDING_SLACK * toU[l]);
+        }
+    }
+    return bound;
+}
+
+bool LandmarkBounds::isBuilt() const {
+    return !landmarks.empty();
+}
+
+int LandmarkBounds::getNodeCount() const {
+    return nodeCount;
+}
+
+int LandmarkBounds::getLandmarkCount() const {
+    return landmarks.size();
+}
+
+const vector<int>& LandmarkBounds::getLandmarks() const {
+    return landmarks;
+}
+
+size_t LandmarkBounds::memoryBytes() const {
+    return (fromLandmark.capacity() + toLandmark.capacity()) * sizeof(double) + landmarks.capacity() * sizeof(int);
+}
@@ -0,0 +1,41 @@
+#ifndef LANDMARK_BOUNDS_H
+#define LANDMARK_BOUNDS_H
+
+#include <vector>
+#include <cstddef>
+#include "thread_pool.h"
+
+using namespace std;
+
+// ALT (A*, Landmarks, Triangle inequality) 하한
+// 몇 개의 랜드마크 L에서 모든 노드까지, 모든 노드에서 L까지의 최단거리를 미리 구해두면
+// 삼각부등식으로 d(u, v) >= max(d(L, v) - d(L, u), d(u, L) - d(v, L)) 를 O(랜드마크 수)에 얻는다.
+// 랜드마크는 이미 고른 랜드마크들에서 가장 먼 노드를 차례로 고른다 (farthest selection).
+class LandmarkBounds {
+public:
+    LandmarkBounds();
+
+    // CSR 도로 그래프로 landmarkCount개 랜드마크의 거리 계산 (노드 u의 간선은 targets/weights의 [offsets[u], offsets[u+1]) 구간)
+    void build(int nodeCount, const vector<int>& offsets, const vector<int>& targets, const vector<double>& weights,
+               int landmarkCount, ThreadPool* pool = nullptr);
+    void clear();
+
+    // from에서 to까지 최단거리의 하한. 길이 없음이 확실하면 INT_MAX, build 이후 추가된 노드는 0
+    double lowerBound(int from, int to) const;
+
+    // Getters
+    bool isBuilt() const;
+    int getNodeCount() const;
+    int getLandmarkCount() const;
+    const vector<int>& getLandmarks() const;
+    size_t memoryBytes() const;
+
+private:
+    int nodeCount;
+    vector<int> landmarks;
+    // 노드별로 랜드마크 거리를 모아 저장 (한 번의 하한 계산이 두 노드의 연속된 구간만 읽도록)
+    vector<double> fromLandmark;   // [v * k + l] = d(landmarks[l], v), 도달 불가면 INT_MAX
+    vector<double> toLandmark;     // [v * k + l] = d(v, landmarks[l])
+};
+
+#endif
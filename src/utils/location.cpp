@@ -41,8 +41,10 @@ void Location::setNode(int node_in) {
 
 // Utility methods
 double Location::calculateDistance(const Location& other) const {
-    // sqrt((x2-x1)^2 + (y2-y1)^2)
-    return sqrt(pow(other.x - this->x, 2) + pow(other.y - this->y, 2));
+    // sqrt((x2-x1)^2 + (y2-y1)^2), 여러 점을 한 번에 계산할 때는 DistanceKernel 사용
+    double dx = other.x - this->x;
+    double dy = other.y - this->y;
+    return sqrt(dx * dx + dy * dy);
 }
 
 bool Location::operator==(const Location& other) const {
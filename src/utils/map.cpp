@@ -1,5 +1,12 @@
 #include "map.h"
 #include <climits>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
 
 using namespace std;
 
@@ -25,31 +32,127 @@ void MapItem::setLocation(const Location& newLocation) {                // �
     location = newLocation;
 }
 
-Map::Map(int width, int height) : width(width), height(height), map_pos(nullptr), map_cost(nullptr) {}       // �� �ʱ�ȭ �۾� (��: �׷��� �ʱ�ȭ ��)
+void RoadGraphBuilder::reserve(size_t edgeCount) {
+    edges.reserve(edgeCount);
+}
+
+void RoadGraphBuilder::addEdge(int from, int to, double weight) {
+    edges.push_back({ from, to, weight });
+}
+
+void RoadGraphBuilder::addRoad(int a, int b, double weight) {
+    edges.push_back({ a, b, weight });
+    edges.push_back({ b, a, weight });
+}
+
+size_t RoadGraphBuilder::edgeCount() const {
+    return edges.size();
+}
+
+vector<RoadEdge> RoadGraphBuilder::release() {
+    vector<RoadEdge> released;
+    released.swap(edges);
+    return released;
+}
+
+Map::Map(int width, int height) : width(width), height(height), mode(MAP_ALL_PAIRS), initialized(false), graphNodeCount(0), landmarkCount(8), allPairsBackend(ALL_PAIRS_DIJKSTRA), defaultProfile(-1), minProfileFactor(1.0), minNodeX(INT_MAX), minNodeY(INT_MAX), maxNodeX(INT_MIN), maxNodeY(INT_MIN), threadCount(0), heuristicScale(1.0), costVersion(0) {}       // �� �ʱ�ȭ �۾� (��: �׷��� �ʱ�ȭ ��)
 
 Map::~Map() {                                                          // 맵 소멸자
-    if (map_pos != nullptr) {
-        for (int i = 0; i < (int)nodes.size(); i++) {
-            delete[] map_pos[i];
+    releaseTables();
+}
+
+void Map::releaseTables() {
+    distanceTable.clear();
+    nextHop.clear();
+    releaseDistanceCache();
+    routeCache.clear();
+    costVersion++;
+    hierarchy.clear();
+    landmarks.clear();
+}
+
+void Map::addItem(const MapItem& item) {                                // �� ������ �߰�
+    items.push_back(item);
+}
+
+bool Map::moveItem(ItemType itemType, int id, const Location& location) {
+    for (MapItem& item : items) {
+        if (item.getItemType() == itemType && item.getId() == id) {
+            item.setLocation(location);
+            return true;
         }
-        delete[] map_pos;
     }
-    
-    if (map_cost != nullptr) {
-        for (int i = 0; i < (int)nodes.size(); i++) {
-            delete[] map_cost[i];
+    return false;
+}
+
+static long long coordinateKey(int x, int y) {
+    return ((long long)x << 32) | (unsigned int)y;
+}
+
+void Map::addLocation(Location& pos) {                                // 맵 아이템 추가
+    auto found = nodeIndex.find(coordinateKey(pos.getX(), pos.getY()));
+    if (found != nodeIndex.end()) {   //주문의 배달지는 대부분 주문자 위치와 같으므로 노드를 새로 만들지 않음
+        pos.node = found->second;
+        return;
+    }
+
+    pos.node = nodes.size();
+    nodes.push_back(pos);   //find_route가 반환하는 노드도 자신의 번호를 알도록 번호를 먼저 기록
+    nodeIndex[coordinateKey(pos.getX(), pos.getY())] = pos.node;
+
+    bool grown = pos.getX() < minNodeX || pos.getY() < minNodeY || pos.getX() > maxNodeX || pos.getY() > maxNodeY;
+    minNodeX = min(minNodeX, pos.getX());
+    minNodeY = min(minNodeY, pos.getY());
+    maxNodeX = max(maxNodeX, pos.getX());
+    maxNodeY = max(maxNodeY, pos.getY());
+    if (grown && mode == MAP_EUCLIDEAN) recheckDefaultProfile();   //사각형이 커지면 가장 긴 직선 도로도 길어짐
+
+    if (initialized && mode != MAP_EUCLIDEAN) {   //초기화 이후 추가된 노드는 간선 없는 노드로 도로 그래프와 거리 테이블에 붙임
+        graphNodeCount++;
+        edgeOffsets.push_back(edgeOffsets.back());
+        if (mode == MAP_ALL_PAIRS) {
+            ownNextHop();
+            distanceTable.resize(graphNodeCount);   //용량은 두 배씩 늘어나므로 노드 추가 비용은 분할상환 O(N)
+            nextHop.resize(graphNodeCount);
         }
-        delete[] map_cost;
     }
 }
 
-void Map::addItem(const MapItem& item) {                                // �� ������ �߰�
-    items.push_back(item);
+void Map::addEdge(const Location& from, const Location& to, double weight) {
+    if (!initialized) {
+        cerr << "Error: Map::addEdge called before SetMap/SetRoadMap." << endl;
+        return;
+    }
+    if (mode == MAP_EUCLIDEAN) return;   //완전 그래프에는 이미 모든 직선 도로가 있음
+
+    int u = from.node;
+    int v = to.node;
+    if (u < 0 || u >= graphNodeCount || v < 0 || v >= graphNodeCount) {
+        cerr << "Error: Road edge " << u << " -> " << v << " refers to an unknown node." << endl;
+        return;
+    }
+
+    if (!isFifoRoad(findEdge(u, v), weight)) {   //이미 있는 도로는 짧아지기만 하므로 새 도로만 걸림
+        cerr << "Error: Road edge " << u << " -> " << v << " is too long for the default travel time profile (FIFO)." << endl;
+        return;
+    }
+
+    if (!insertEdge(u, v, weight)) return;
+    routeCache.clear();
+    costVersion++;
+    landmarks.clear();   //짧아진 길이 생기면 랜드마크 하한이 실제보다 클 수 있음
+
+    if (mode == MAP_ALL_PAIRS) {
+        relaxInsertedEdge(u, v, weight);
+    }
+    else if (mode == MAP_CONTRACTION_HIERARCHY) {   //CH는 구조가 바뀌면 다시 전처리해야 함
+        hierarchy.build(graphNodeCount, edgeOffsets, edgeTargets, edgeWeights);
+    }
 }
 
-void Map::addLocation(Location& pos) {                                // 맵 아이템 추가
-    nodes.push_back(pos);
-    pos.node = nodes.size() - 1;
+int Map::findNode(int x, int y) const {
+    auto found = nodeIndex.find(coordinateKey(x, y));
+    return found == nodeIndex.end() ? -1 : found->second;
 }
 
 vector<MapItem> Map::getAllItems() const {                              // ��� �� ������ ��ȯ
@@ -65,115 +168,1243 @@ int Map::getHeight() const {                                            // �
 }
 
 void Map::SetMap(int** arr) {
-    map_pos = new double*[nodes.size()];
-    for (int i = 0; i < nodes.size(); i++)
-    {
-        map_pos[i] = new double[nodes.size()];
+    int n = nodes.size();
+    bool complete = true;
+    for (int i = 0; i < n && complete; i++) {
+        for (int j = 0; j < n; j++) {
+            if (arr[i][j] != 1) {
+                complete = false;
+                break;
+            }
+        }
+    }
+
+    vector<RoadEdge> edges;
+    if (!complete) {
+        PointArrays points(nodes);
+        vector<double> distances(n);
+        for (int i = 0; i < n; i++) {
+            DistanceKernel::oneToMany(nodes[i], points, distances.data());   //nodes[i]까지의 직선거리를 한 행씩 일괄 계산
+            for (int j = 0; j < n; j++) {
+                if (i == j || arr[i][j] != 1) continue;
+                edges.push_back({ j, i, distances[j] });   //arr[i][j]=1 : items[j] -> items[i] 길
+            }
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        delete[] arr[i];
+    }
+    delete[] arr;
+
+    if (complete) {   //완전 그래프면 최단거리가 곧 직선거리이므로 행렬을 만들 필요가 없음
+        SetEuclideanMap();
+        return;
+    }
+
+    SetRoadMap(move(edges));
+}
+
+void Map::SetRoadMap(const vector<RoadEdge>& edges, MapMode roadMode) {
+    SetRoadMap(vector<RoadEdge>(edges), roadMode);
+}
+
+void Map::SetRoadMap(RoadGraphBuilder&& builder, MapMode roadMode) {
+    SetRoadMap(builder.release(), roadMode);
+}
+
+void Map::SetRoadMap(vector<RoadEdge>&& edges, MapMode roadMode) {
+    releaseTables();
+    buildRoadGraph(move(edges));
+
+    mode = roadMode;
+    initialized = true;
+    recheckDefaultProfile();   //새 도로 그래프에 기본 프로필보다 긴 도로가 있을 수 있음
+
+    if (mode == MAP_ALL_PAIRS) {
+        buildAllPairs();
+    }
+    else if (mode == MAP_CONTRACTION_HIERARCHY) {
+        hierarchy.build(graphNodeCount, edgeOffsets, edgeTargets, edgeWeights);
+    }
+}
+
+void Map::buildRoadGraph(vector<RoadEdge>&& edges) {   //간선을 출발 노드별로 계수 정렬해 CSR 배열로 압축 (O(N + E))
+    graphNodeCount = nodes.size();
+    heuristicScale = 1.0;
+    edgeProfile.clear();
+    updateMinProfileFactor();
+    edgeOffsets.assign(graphNodeCount + 1, 0);
+
+    auto valid = [this](const RoadEdge& edge) {
+        return edge.from >= 0 && edge.from < graphNodeCount && edge.to >= 0 && edge.to < graphNodeCount;
+    };
+    for (const RoadEdge& edge : edges) {
+        if (!valid(edge)) {
+            cerr << "Error: Road edge " << edge.from << " -> " << edge.to << " refers to an unknown node." << endl;
+            continue;
+        }
+        edgeOffsets[edge.from + 1]++;
+    }
+    for (int u = 0; u < graphNodeCount; u++) {
+        edgeOffsets[u + 1] += edgeOffsets[u];
+    }
+
+    edgeTargets.assign(edgeOffsets[graphNodeCount], 0);
+    edgeWeights.assign(edgeOffsets[graphNodeCount], 0);
+    vector<int> cursor(edgeOffsets.begin(), edgeOffsets.end() - 1);
+    for (const RoadEdge& edge : edges) {
+        if (!valid(edge)) continue;
+        int position = cursor[edge.from]++;
+        edgeTargets[position] = edge.to;
+        edgeWeights[position] = edge.weight;
+    }
+    vector<RoadEdge>().swap(edges);   //넘겨받은 간선 버퍼는 여기서 해제
+
+    //행마다 도착 노드 순으로 정렬하고, 중복 간선은 가장 짧은 것만 남기며 앞으로 당겨 채움
+    vector<pair<int, double>> row;
+    int write = 0;
+    for (int u = 0; u < graphNodeCount; u++) {
+        int begin = edgeOffsets[u];
+        int end = edgeOffsets[u + 1];
+        row.clear();
+        for (int e = begin; e < end; e++) {
+            row.push_back({ edgeTargets[e], edgeWeights[e] });
+        }
+        sort(row.begin(), row.end());
+
+        edgeOffsets[u] = write;
+        for (int k = 0; k < (int)row.size(); k++) {
+            if (k > 0 && row[k].first == row[k - 1].first) continue;
+            edgeTargets[write] = row[k].first;
+            edgeWeights[write] = row[k].second;
+            updateHeuristicScale(u, row[k].first, row[k].second);
+            write++;
+        }
+    }
+    edgeOffsets[graphNodeCount] = write;
+    edgeTargets.resize(write);
+    edgeWeights.resize(write);
+    edgeTargets.shrink_to_fit();
+    edgeWeights.shrink_to_fit();
+}
+
+void Map::buildAllPairs() {
+    releaseDistanceCache();
+    if (!distanceCacheDirectory.empty() && loadDistanceCache()) return;
+
+    distanceTable.reset(graphNodeCount);
+    nextHop.reset(graphNodeCount);
+
+    if (allPairsBackend == ALL_PAIRS_FLOYD_WARSHALL) {
+        buildAllPairsFloydWarshall();
+    }
+    else {
+        buildAllPairsDijkstra();
+    }
+
+    if (!distanceCacheDirectory.empty()) {
+        saveDistanceCache();
+    }
+}
+
+void Map::buildAllPairsDijkstra() {
+    vector<int> sources(graphNodeCount);
+    for (int j = 0; j < graphNodeCount; j++) {
+        sources[j] = j;
+    }
+    computeRows(sources);
+}
+
+void Map::computeRows(const vector<int>& sources) {
+    distanceTable.detach();   //캐시 파일에서 읽은 테이블이면 스레드들이 쓰기 전에 미리 복사
+    ownNextHop();
+
+    //출발점 j마다 j행만 기록하므로 출발점 단위로 나눠 병렬 계산. 작업 버퍼는 스레드마다 따로 둔다
+    int workers = threadPool().getThreadCount();
+    vector<vector<double>> rows(workers, vector<double>(graphNodeCount));
+    vector<vector<int>> parents(workers, vector<int>(graphNodeCount));
+    vector<vector<int>> hops(workers, vector<int>(graphNodeCount));
+    threadPool().parallelFor(sources.size(), [&](int worker, int index) {
+        int j = sources[index];
+        double* row = rows[worker].data();
+        int* parent = parents[worker].data();
+        dijkstra(j, row, -1, parent);
+        distanceTable.setRow(j, row);   //j행에 j에서 출발하는 최단거리 기록
+        fillNextHopRow(j, parent, row, hops[worker].data());
+        nextHop.setRow(j, hops[worker].data());
+    });
+}
+
+void Map::buildAllPairsFloydWarshall() {
+    FloydWarshallMatrix matrix(graphNodeCount);
+    for (int u = 0; u < graphNodeCount; u++) {
+        for (int e = edgeOffsets[u]; e < edgeOffsets[u + 1]; e++) {
+            matrix.relax(u, edgeTargets[e], edgeWeights[e]);
+        }
     }
+    matrix.solve(&threadPool());
+
+    //다음 노드는 거리 행렬에서 역으로 구함: u의 나가는 간선 중 간선 + 남은 거리가 가장 작은 이웃 (O(E*N))
+    threadPool().parallelFor(graphNodeCount, [&](int, int u) {
+        const double* row = matrix.row(u);
+        distanceTable.setRow(u, row);
 
+        //nextHop.reset이 대각선은 자기 자신, 나머지는 -1로 채워 두었으므로 길이 있는 칸만 기록
+        for (int t = 0; t < graphNodeCount; t++) {
+            if (t == u || row[t] >= INT_MAX) continue;
 
-    for (int i = 0;i < nodes.size();i++) {
-        for (int j = 0;j < nodes.size();j++) {
-            if (arr[i][j] == 1) {
-                map_pos[i][j] = nodes[i].calculateDistance(nodes[j]); //i와 j사이의 거리는 추후에 임의로 수정가능한 코드
+            double best = INT_MAX;
+            int hop = -1;
+            for (int e = edgeOffsets[u]; e < edgeOffsets[u + 1]; e++) {
+                double cost = edgeWeights[e] + matrix.row(edgeTargets[e])[t];
+                if (cost < best) {
+                    best = cost;
+                    hop = edgeTargets[e];
+                }
             }
-            else if (arr[i][j] == 0) {
-                map_pos[i][j] = -1;   //inf 취급
+            nextHop.set(u, t, hop);
+        }
+    });
+}
+
+void Map::setAllPairsBackend(AllPairsBackend backend) {
+    allPairsBackend = backend;
+    costVersion++;
+    if (initialized && mode == MAP_ALL_PAIRS) {
+        buildAllPairs();
+    }
+}
+
+AllPairsBackend Map::getAllPairsBackend() const {
+    return allPairsBackend;
+}
+
+// 거리 테이블 캐시 파일 형식. 헤더 뒤에 거리 테이블 행들(rowCapacity 간격, 저장 형식 그대로)과
+// 다음 노드 행들(hopRowCapacity 간격, hopElementBytes 바이트 원소)이 64바이트 경계에 맞춰 이어진다. 형식이 바뀌면 DISTANCE_CACHE_VERSION을 올릴 것
+static const char DISTANCE_CACHE_MAGIC[8] = { 'D', 'L', 'V', 'D', 'I', 'S', 'T', '\0' };
+static const uint32_t DISTANCE_CACHE_VERSION = 2;
+static const size_t DISTANCE_CACHE_ALIGN = 64;
+
+struct DistanceCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t storage;
+    double scale;
+    uint64_t key;
+    int32_t nodeCount;
+    int32_t rowCapacity;
+    int32_t hopRowCapacity;
+    int32_t hopElementBytes;
+    uint64_t distanceOffset;
+    uint64_t hopOffset;
+    uint64_t fileSize;
+};
+
+static size_t alignCacheOffset(size_t offset) {
+    return (offset + DISTANCE_CACHE_ALIGN - 1) / DISTANCE_CACHE_ALIGN * DISTANCE_CACHE_ALIGN;
+}
+
+void Map::setDistanceCacheDirectory(const string& directory) {
+    distanceCacheDirectory = directory;
+}
+
+bool Map::isDistanceTableCached() const {
+    return distanceTable.isAttached() || nextHop.isAttached();
+}
+
+unsigned long long Map::graphHash() const {   //FNV-1a 64비트
+    unsigned long long hash = 1469598103934665603ULL;
+    auto mix = [&hash](const void* bytes, size_t count) {
+        const unsigned char* p = static_cast<const unsigned char*>(bytes);
+        for (size_t i = 0; i < count; i++) {
+            hash ^= p[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    mix(&graphNodeCount, sizeof(graphNodeCount));
+    for (int u = 0; u < graphNodeCount; u++) {
+        int coordinate[2] = { nodes[u].getX(), nodes[u].getY() };
+        mix(coordinate, sizeof(coordinate));
+    }
+    mix(edgeOffsets.data(), edgeOffsets.size() * sizeof(int));
+    mix(edgeTargets.data(), edgeTargets.size() * sizeof(int));
+    mix(edgeWeights.data(), edgeWeights.size() * sizeof(double));
+
+    int storage = distanceTable.getStorage();
+    double scale = distanceTable.getScale();
+    mix(&storage, sizeof(storage));
+    mix(&scale, sizeof(scale));
+    return hash;
+}
+
+string Map::getDistanceCachePath() const {
+    if (distanceCacheDirectory.empty()) return "";   //캐시 디렉터리를 정하지 않았으면 경로 없음
+    char name[40];
+    snprintf(name, sizeof(name), "map_%016llx.dist", graphHash());
+    string path = distanceCacheDirectory;
+    if (path.back() != '/') path += '/';
+    return path + name;
+}
+
+bool Map::loadDistanceCache() {
+    unique_ptr<MappedFile> file(new MappedFile());
+    if (!file->open(getDistanceCachePath())) return false;   //캐시 없음
+
+    DistanceCacheHeader header;
+    if (file->size() < sizeof(header)) return false;
+    memcpy(&header, file->data(), sizeof(header));
+
+    int n = graphNodeCount;
+    size_t hopBytes = (size_t)n * header.hopRowCapacity * header.hopElementBytes;
+    bool valid = memcmp(header.magic, DISTANCE_CACHE_MAGIC, sizeof(header.magic)) == 0
+        && header.version == DISTANCE_CACHE_VERSION
+        && header.key == graphHash()
+        && header.nodeCount == n
+        && header.storage == (uint32_t)distanceTable.getStorage()
+        && header.scale == distanceTable.getScale()
+        && header.rowCapacity >= n
+        && header.hopRowCapacity >= n
+        && (header.hopElementBytes == 4 || (header.hopElementBytes == 2 && NextHopTable::fitsNarrow(n)))
+        && header.fileSize == file->size()
+        && header.distanceOffset % DISTANCE_CACHE_ALIGN == 0
+        && header.hopOffset % DISTANCE_CACHE_ALIGN == 0
+        && header.hopOffset + hopBytes <= header.fileSize;
+    if (!valid) {
+        cerr << "Error: Distance cache " << getDistanceCachePath() << " does not match this map, rebuilding." << endl;
+        return false;
+    }
+
+    //distanceTable은 attach 전에 저장 형식이 이미 같으므로 행 간격만 맞추면 됨
+    distanceTable.attach(file->data() + header.distanceOffset, n, header.rowCapacity);
+    if (header.distanceOffset + (size_t)n * distanceTable.rowBytes() > header.hopOffset) {
+        cerr << "Error: Distance cache " << getDistanceCachePath() << " is truncated, rebuilding." << endl;
+        distanceTable.clear();
+        return false;
+    }
+    nextHop.attach(file->data() + header.hopOffset, n, header.hopRowCapacity, header.hopElementBytes);
+    distanceCache = move(file);
+    return true;
+}
+
+void Map::saveDistanceCache() const {
+    int n = graphNodeCount;
+    DistanceCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DISTANCE_CACHE_MAGIC, sizeof(header.magic));
+    header.version = DISTANCE_CACHE_VERSION;
+    header.storage = distanceTable.getStorage();
+    header.scale = distanceTable.getScale();
+    header.key = graphHash();
+    header.nodeCount = n;
+    header.rowCapacity = distanceTable.getCapacity();
+    header.hopRowCapacity = nextHop.getCapacity();
+    header.hopElementBytes = nextHop.getElementBytes();
+    header.distanceOffset = alignCacheOffset(sizeof(header));
+    header.hopOffset = alignCacheOffset(header.distanceOffset + (size_t)n * distanceTable.rowBytes());
+    header.fileSize = header.hopOffset + (size_t)n * nextHop.rowBytes();
+
+    //다른 프로세스가 쓰다 만 파일을 읽지 않도록 임시 파일에 다 쓴 뒤 이름을 바꿈
+    string path = getDistanceCachePath();
+    string temporary = path + ".tmp";
+    ofstream out(temporary, ios::binary | ios::trunc);
+    if (!out) {
+        cerr << "Error: Cannot write distance cache " << temporary << endl;
+        return;
+    }
+
+    const char padding[DISTANCE_CACHE_ALIGN] = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(padding, header.distanceOffset - sizeof(header));
+    for (int u = 0; u < n; u++) {
+        out.write(reinterpret_cast<const char*>(distanceTable.rowData(u)), distanceTable.rowBytes());
+    }
+    out.write(padding, header.hopOffset - (header.distanceOffset + (size_t)n * distanceTable.rowBytes()));
+    for (int u = 0; u < n; u++) {
+        out.write(reinterpret_cast<const char*>(nextHop.rowData(u)), nextHop.rowBytes());
+    }
+    out.close();
+
+    if (!out || rename(temporary.c_str(), path.c_str()) != 0) {
+        cerr << "Error: Cannot write distance cache " << path << endl;
+        remove(temporary.c_str());
+    }
+}
+
+void Map::releaseDistanceCache() {
+    if (distanceTable.isAttached()) {
+        distanceTable.clear();
+    }
+    if (nextHop.isAttached()) {
+        nextHop.clear();
+    }
+    distanceCache.reset();
+}
+
+void Map::ownNextHop() {
+    if (!nextHop.isAttached()) return;
+
+    nextHop.detach();
+    if (!distanceTable.isAttached()) {   //둘 다 자기 버퍼로 옮겼으면 매핑 해제
+        distanceCache.reset();
+    }
+}
+
+ThreadPool& Map::threadPool() const {
+    if (!pool) {
+        pool.reset(new ThreadPool(threadCount));
+    }
+    return *pool;
+}
+
+void Map::setThreadCount(int threads) {
+    if (threads == threadCount && pool) return;
+    threadCount = threads;
+    pool.reset();
+}
+
+void Map::setLandmarkCount(int count) {
+    if (count < 0) count = 0;
+    if (count != landmarkCount) landmarks.clear();
+    landmarkCount = count;
+}
+
+int Map::getLandmarkCount() const {
+    return landmarkCount;
+}
+
+void Map::prepareLowerBounds() {
+    if (!initialized || (mode != MAP_ROAD_GRAPH && mode != MAP_CONTRACTION_HIERARCHY)) return;
+    if (landmarkCount == 0 || (landmarks.isBuilt() && landmarks.getNodeCount() == graphNodeCount)) return;
+    landmarks.build(graphNodeCount, edgeOffsets, edgeTargets, edgeWeights, landmarkCount, &threadPool());
+}
+
+CostMatrix Map::GetMap_costTable(const vector<int>& sources, const vector<int>& targets) const {
+    CostMatrix table;
+    table.rows = sources.size();
+    table.cols = targets.size();
+    table.costs.assign((size_t)table.rows * table.cols, INT_MAX);
+    if (table.costs.empty()) return table;
+
+    int nodeCount = nodes.size();
+    for (int node : sources) {
+        if (node < 0 || node >= nodeCount) {
+            cerr << "Error: Map::GetMap_costTable got unknown node " << node << endl;
+            return table;
+        }
+    }
+    for (int node : targets) {
+        if (node < 0 || node >= nodeCount) {
+            cerr << "Error: Map::GetMap_costTable got unknown node " << node << endl;
+            return table;
+        }
+    }
+
+    if (mode == MAP_EUCLIDEAN) {   //좌표를 SoA로 모아 벡터 커널로 한 번에 계산
+        PointArrays sourcePoints, targetPoints;
+        sourcePoints.reserve(table.rows);
+        targetPoints.reserve(table.cols);
+        for (int node : sources) sourcePoints.add(nodes[node]);
+        for (int node : targets) targetPoints.add(nodes[node]);
+        DistanceKernel::manyToMany(sourcePoints, targetPoints, table.costs.data());
+        return table;
+    }
+    if (!initialized || mode == MAP_ALL_PAIRS) {   //표를 바로 읽음
+        for (int i = 0; i < table.rows; i++) {
+            for (int j = 0; j < table.cols; j++) {
+                table.costs[(size_t)i * table.cols + j] = GetMap_cost(sources[i], targets[j]);
             }
         }
+        return table;
     }
 
-    map_cost = new double* [nodes.size()];
-    for (int i = 0; i < nodes.size(); i++)
-    {
-        map_cost[i] = new double[nodes.size()];
+    if (mode == MAP_CONTRACTION_HIERARCHY && hierarchy.getNodeCount() == graphNodeCount) {
+        hierarchy.manyToMany(sources, targets, table.costs.data(), &threadPool());
+        return table;
     }
 
-    for (int j = 0; j < nodes.size(); j++)
-    {
-        double* temp = new double[nodes.size()];
-        for (int i = 0; i < nodes.size(); i++)
-        {
-            temp[i] = INT_MAX;
+    //도로 그래프에 없는 노드(구성 이후 추가, 간선 없음)는 자기 자신만 0
+    vector<char> isTarget(graphNodeCount, 0);
+    int targetCount = 0;
+    for (int node : targets) {
+        if (node < graphNodeCount && !isTarget[node]) {
+            isTarget[node] = 1;
+            targetCount++;
         }
-        temp[j] = 0;
+    }
+    int workers = threadPool().getThreadCount();
+    vector<vector<double>> rows(workers, vector<double>(graphNodeCount));
+    threadPool().parallelFor(table.rows, [&](int worker, int i) {
+        double* out = table.costs.data() + (size_t)i * table.cols;
+        int source = sources[i];
+        if (source >= graphNodeCount) {
+            for (int j = 0; j < table.cols; j++) {
+                if (targets[j] == source) out[j] = 0;
+            }
+            return;
+        }
+        double* dist = rows[worker].data();
+        dijkstra(source, dist, -1, nullptr, isTarget.data(), targetCount);
+        for (int j = 0; j < table.cols; j++) {
+            if (targets[j] < graphNodeCount) out[j] = dist[targets[j]];
+        }
+    });
+    return table;
+}
 
-        vector<int> v;
-        loop_cost(v, temp, j);
+double Map::lowerBound(int crt, int trg) const {
+    if (crt == trg) return 0;
+    if (crt < 0 || trg < 0) return 0;
+    if (mode == MAP_EUCLIDEAN) {
+        return nodes[crt].calculateDistance(nodes[trg]) * minProfileFactor;
+    }
+    if (crt >= graphNodeCount || trg >= graphNodeCount) return INT_MAX;
 
-        for (int i = 0; i < nodes.size(); i++)
-        {
-            map_cost[j][i] = temp[i];
+    if (mode == MAP_ALL_PAIRS) {
+        double distance = distanceTable.get(crt, trg);
+        if (defaultProfile < 0 && edgeProfile.empty()) return distance;
+        return max(0.0, distance - distanceTolerance(distance)) * minProfileFactor;   //시간 의존 탐색은 반올림 없는 간선 합
+    }
+
+    double bound = heuristicScale * nodes[crt].calculateDistance(nodes[trg]);
+    if (landmarks.isBuilt()) {
+        bound = max(bound, landmarks.lowerBound(crt, trg));
+    }
+    return bound * minProfileFactor;
+}
+
+unsigned long long Map::getCostVersion() const {
+    return costVersion;
+}
+
+bool Map::isConcurrentQuerySafe() const {
+    if (mode == MAP_EUCLIDEAN) return true;
+    return mode == MAP_ALL_PAIRS && !hasTravelTimeProfiles();
+}
+
+int Map::getThreadCount() const {
+    return pool ? pool->getThreadCount() : (threadCount > 0 ? threadCount : ThreadPool::hardwareThreads());
+}
+
+void Map::fillNextHopRow(int source, const int* parent, const double* dist, int* row) const {
+    //최단경로 트리에서 각 노드의 조상 중 source 바로 아래 노드가 첫 번째 hop. 이미 구한 조상에서 멈추므로 행 전체가 O(N)
+    int n = graphNodeCount;
+    fill(row, row + n, -1);
+    row[source] = source;
+
+    vector<int> chain;
+    for (int t = 0; t < n; t++) {
+        if (row[t] != -1 || dist[t] >= INT_MAX) continue;
+
+        int u = t;
+        while (row[u] == -1 && parent[u] != source) {
+            chain.push_back(u);
+            u = parent[u];
+        }
+        int hop = row[u] != -1 ? row[u] : u;
+        row[u] = hop;
+        for (int node : chain) {
+            row[node] = hop;
         }
+        chain.clear();
+    }
+}
+
+void Map::SetEuclideanMap() {
+    mode = MAP_EUCLIDEAN;
+    costVersion++;
+    initialized = true;
+    recheckDefaultProfile();
+}
 
-        delete[] temp;
+void Map::setDistanceStorage(DistanceStorage storage, double scale) {
+    distanceTable.setStorage(storage, scale);
+    costVersion++;
+    if (initialized && mode == MAP_ALL_PAIRS) {
+        buildAllPairs();
     }
+}
 
+DistanceStorage Map::getDistanceStorage() const {
+    return distanceTable.getStorage();
+}
 
-    for (int i = 0;i < nodes.size();i++) {
-        delete[] arr[i];
+MapMode Map::getMode() const {
+    return mode;
+}
+
+bool Map::isInitialized() const {
+    return initialized;
+}
+
+bool Map::insertEdge(int from, int to, double weight) {   //CSR 행에 간선을 정렬 위치로 끼워넣음. 그래프가 바뀌었으면 true
+    auto first = edgeTargets.begin() + edgeOffsets[from];
+    auto last = edgeTargets.begin() + edgeOffsets[from + 1];
+    auto it = lower_bound(first, last, to);
+    int position = it - edgeTargets.begin();
+
+    if (it != last && *it == to) {
+        if (weight >= edgeWeights[position]) return false;
+        edgeWeights[position] = weight;
+        updateHeuristicScale(from, to, weight);
+        return true;
     }
+    updateHeuristicScale(from, to, weight);
 
-    delete[] arr;
+    edgeTargets.insert(it, to);
+    edgeWeights.insert(edgeWeights.begin() + position, weight);
+    if (!edgeProfile.empty()) {
+        edgeProfile.insert(edgeProfile.begin() + position, -1);
+    }
+    for (int u = from + 1; u <= graphNodeCount; u++) {
+        edgeOffsets[u]++;
+    }
+    return true;
+}
+
+int Map::findEdge(int from, int to) const {
+    auto first = edgeTargets.begin() + edgeOffsets[from];
+    auto last = edgeTargets.begin() + edgeOffsets[from + 1];
+    auto it = lower_bound(first, last, to);
+    if (it == last || *it != to) return -1;
+    return it - edgeTargets.begin();
+}
+
+bool Map::updateEdgeWeight(const Location& from, const Location& to, double weight) {
+    return updateEdgeWeights({ { from.node, to.node, weight } }) > 0;
+}
+
+int Map::updateEdgeWeights(const vector<RoadEdge>& changes) {
+    if (!initialized || mode == MAP_EUCLIDEAN) {
+        cerr << "Error: Map::updateEdgeWeights needs a road graph (SetMap/SetRoadMap)." << endl;
+        return 0;
+    }
+
+    //같은 도로가 여러 번 나오면 마지막 값만 적용
+    vector<int> positions;
+    unordered_map<int, double> newWeight;
+    for (const RoadEdge& change : changes) {
+        int u = change.from;
+        int v = change.to;
+        if (u < 0 || u >= graphNodeCount || v < 0 || v >= graphNodeCount) {
+            cerr << "Error: Road edge " << u << " -> " << v << " refers to an unknown node." << endl;
+            continue;
+        }
+        int position = findEdge(u, v);
+        if (position < 0) {
+            cerr << "Error: Road edge " << u << " -> " << v << " does not exist." << endl;
+            continue;
+        }
+        if (!isFifoRoad(position, change.weight)) {   //setEdgeProfile과 같은 기준, 길어지는 도로만 걸림
+            cerr << "Error: Road edge " << u << " -> " << v << " is too long for its travel time profile (FIFO)." << endl;
+            continue;
+        }
+        if (newWeight.find(position) == newWeight.end()) positions.push_back(position);
+        newWeight[position] = change.weight;
+    }
+
+    vector<RoadEdge> decreased;   // (from, to, 새 가중치)
+    vector<RoadEdge> increased;   // (from, to, 옛 가중치)
+    for (int position : positions) {
+        int u = upper_bound(edgeOffsets.begin(), edgeOffsets.end(), position) - edgeOffsets.begin() - 1;
+        double weight = newWeight[position];
+        if (weight < edgeWeights[position]) decreased.push_back({ u, edgeTargets[position], weight });
+        else if (weight > edgeWeights[position]) increased.push_back({ u, edgeTargets[position], edgeWeights[position] });
+    }
+    int changed = decreased.size() + increased.size();
+    if (changed == 0) return 0;
+    routeCache.clear();
+    costVersion++;
+    if (!decreased.empty()) landmarks.clear();   //길어지기만 했으면 랜드마크 하한은 여전히 유효
+
+    //짧아진 간선이 적으면 하나씩 완화해서 (addEdge와 같은 방식) 테이블을 그 시점 그래프의 정확한 최단거리로 유지한다.
+    //많으면 완화가 출발점별 재계산보다 비싸지므로, 길어진 간선과 함께 영향받는 출발점 행만 골라 다시 계산한다.
+    bool relaxDecreases = mode == MAP_ALL_PAIRS && (int)decreased.size() * 8 < graphNodeCount;
+    for (const RoadEdge& edge : decreased) {
+        edgeWeights[findEdge(edge.from, edge.to)] = edge.weight;
+        updateHeuristicScale(edge.from, edge.to, edge.weight);
+        if (relaxDecreases) relaxInsertedEdge(edge.from, edge.to, edge.weight);
+    }
+
+    //출발점 s의 행이 바뀔 수 있는 경우는 (1) s의 최단경로 트리가 길어진 간선을 쓰거나
+    //(2) 새로 짧아진 간선을 쓰면 s에서 그 간선 끝까지가 짧아지는 경우 뿐이다. 둘 다 아닌 행은 그대로 정확하다.
+    vector<char> affected;
+    if (mode == MAP_ALL_PAIRS && (!increased.empty() || !relaxDecreases)) {
+        affected.assign(graphNodeCount, 0);
+        for (const RoadEdge& edge : increased) {
+            for (int s = 0; s < graphNodeCount; s++) {
+                if (affected[s]) continue;
+                double viaEdge = distanceTable.get(s, edge.from) + edge.weight;
+                double direct = distanceTable.get(s, edge.to);
+                if (viaEdge < INT_MAX && viaEdge <= direct + distanceTolerance(direct)) affected[s] = 1;   //s의 최단경로 트리가 이 간선을 씀
+            }
+        }
+        if (!relaxDecreases) {
+            for (const RoadEdge& edge : decreased) {
+                for (int s = 0; s < graphNodeCount; s++) {
+                    if (affected[s]) continue;
+                    double viaEdge = distanceTable.get(s, edge.from) + edge.weight;
+                    double direct = distanceTable.get(s, edge.to);
+                    if (viaEdge < INT_MAX && viaEdge <= direct + distanceTolerance(direct)) affected[s] = 1;
+                }
+            }
+        }
+    }
+
+    for (const RoadEdge& edge : increased) {
+        int position = findEdge(edge.from, edge.to);
+        edgeWeights[position] = newWeight[position];   //길어진 간선은 휴리스틱 비율을 줄일 필요 없음
+    }
+
+    if (!affected.empty()) {
+        vector<int> sources;
+        for (int s = 0; s < graphNodeCount; s++) {
+            if (affected[s]) sources.push_back(s);
+        }
+        computeRows(sources);
+    }
+    if (mode == MAP_CONTRACTION_HIERARCHY) {   //CH는 가중치가 바뀌면 다시 전처리해야 함
+        hierarchy.build(graphNodeCount, edgeOffsets, edgeTargets, edgeWeights);
+    }
+    return changed;
+}
+
+static unsigned long long hilbertKey(unsigned int x, unsigned int y) {   //16비트 좌표의 힐베르트 곡선 위치 (사분면을 돌려가며 한 비트씩 내려감)
+    unsigned long long d = 0;
+    for (unsigned int s = 1u << 15; s > 0; s >>= 1) {
+        unsigned int rx = (x & s) ? 1 : 0;
+        unsigned int ry = (y & s) ? 1 : 0;
+        d += (unsigned long long)s * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = 0xFFFF - x;
+                y = 0xFFFF - y;
+            }
+            swap(x, y);
+        }
+    }
+    return d;
+}
+
+static unsigned long long mortonKey(unsigned int x, unsigned int y) {   //x, y 비트를 번갈아 섞음
+    unsigned long long d = 0;
+    for (int bit = 0; bit < 16; bit++) {
+        d |= (unsigned long long)((x >> bit) & 1) << (2 * bit);
+        d |= (unsigned long long)((y >> bit) & 1) << (2 * bit + 1);
+    }
+    return d;
+}
+
+vector<int> Map::reorderNodes(NodeOrder order) {
+    int n = nodes.size();
+    vector<int> newId(n);
+    for (int u = 0; u < n; u++) newId[u] = u;
+    if (n == 0) return newId;
+    if (initialized && mode != MAP_EUCLIDEAN && graphNodeCount != n) {
+        cerr << "Error: Map::reorderNodes found nodes outside the road graph." << endl;
+        return newId;
+    }
+
+    //좌표를 정사각형 경계 상자 기준 16비트로 맞춘 뒤 곡선 위치로 정렬 (같은 위치는 기존 번호 순)
+    int minX = INT_MAX, minY = INT_MAX, maxX = INT_MIN, maxY = INT_MIN;
+    for (const Location& node : nodes) {
+        minX = min(minX, node.getX());
+        minY = min(minY, node.getY());
+        maxX = max(maxX, node.getX());
+        maxY = max(maxY, node.getY());
+    }
+    long long span = max(max((long long)maxX - minX, (long long)maxY - minY), 1LL);
+    vector<pair<unsigned long long, int>> keyed(n);
+    for (int u = 0; u < n; u++) {
+        unsigned int x = (unsigned int)(((long long)nodes[u].getX() - minX) * 0xFFFF / span);
+        unsigned int y = (unsigned int)(((long long)nodes[u].getY() - minY) * 0xFFFF / span);
+        keyed[u] = { order == NODE_ORDER_MORTON ? mortonKey(x, y) : hilbertKey(x, y), u };
+    }
+    sort(keyed.begin(), keyed.end());
+
+    vector<int> oldId(n);
+    bool unchanged = true;
+    for (int i = 0; i < n; i++) {
+        oldId[i] = keyed[i].second;
+        newId[oldId[i]] = i;
+        if (oldId[i] != i) unchanged = false;
+    }
+    if (unchanged) return newId;
+
+    vector<Location> reordered(n);
+    for (int i = 0; i < n; i++) {
+        reordered[i] = nodes[oldId[i]];
+        reordered[i].node = i;
+    }
+    nodes.swap(reordered);
+    for (auto& entry : nodeIndex) {
+        entry.second = newId[entry.second];
+    }
+    for (MapItem& item : items) {
+        Location location = item.getLocation();
+        if (location.node < 0 || location.node >= n) continue;
+        location.node = newId[location.node];
+        item.setLocation(location);
+    }
+
+    if (graphNodeCount == n) {   //CSR 행을 새 번호 순으로 옮기고, 행 안의 간선도 새 도착 번호 순으로 다시 정렬
+        vector<int> offsets(n + 1, 0);
+        vector<int> targets(edgeTargets.size());
+        vector<double> weights(edgeWeights.size());
+        vector<int> edgeProfiles(edgeProfile.size());
+        vector<int> row;
+        int write = 0;
+        for (int u = 0; u < n; u++) {
+            row.clear();
+            for (int e = edgeOffsets[oldId[u]]; e < edgeOffsets[oldId[u] + 1]; e++) {
+                row.push_back(e);
+            }
+            sort(row.begin(), row.end(), [&](int a, int b) { return newId[edgeTargets[a]] < newId[edgeTargets[b]]; });
+            for (int e : row) {
+                targets[write] = newId[edgeTargets[e]];
+                weights[write] = edgeWeights[e];
+                if (!edgeProfile.empty()) edgeProfiles[write] = edgeProfile[e];
+                write++;
+            }
+            offsets[u + 1] = write;
+        }
+        edgeOffsets.swap(offsets);
+        edgeTargets.swap(targets);
+        edgeWeights.swap(weights);
+        edgeProfile.swap(edgeProfiles);
+    }
+
+    if (mode == MAP_ALL_PAIRS && distanceTable.size() == n) {   //new (i, j) = old (oldId[i], oldId[j]), 다음 노드 값도 새 번호로
+        ownNextHop();
+        distanceTable.permute(oldId);
+        nextHop.permute(oldId, newId);
+        releaseDistanceCache();   //캐시 파일은 기존 번호 기준이므로 매핑을 놓음
+    }
+
+    routeCache.clear();
+    costVersion++;
+    landmarks.clear();   //랜드마크 거리는 노드 번호 순으로 저장되어 있으므로 prepareLowerBounds에서 다시 계산
+    if (mode == MAP_CONTRACTION_HIERARCHY && hierarchy.getNodeCount() == n) {
+        hierarchy.build(graphNodeCount, edgeOffsets, edgeTargets, edgeWeights);
+    }
+    return newId;
+}
+
+double Map::distanceTolerance(double distance) const {
+    if (distance >= INT_MAX) return 0;
+    switch (distanceTable.getStorage()) {
+    case DISTANCE_FLOAT: return distance * 1e-6 + 1e-6;
+    case DISTANCE_UINT16: return distanceTable.getScale();
+    default: return distance * 1e-12 + 1e-12;
+    }
+}
+
+void Map::relaxInsertedEdge(int from, int to, double weight) {
+    //from->to 간선으로 짧아지는 쌍은 (from까지 와서 이 간선을 쓰면 이득인 출발지) x (이 간선 뒤로 이어가면 이득인 도착지) 뿐이다.
+    //새 노드를 붙이는 경우 한쪽 집합은 새 노드 하나이므로 O(N)에 새 행/열만 채워진다.
+    DistanceTable& table = distanceTable;
+    if (weight >= table.get(from, to)) return;
+    ownNextHop();
+
+    vector<int> sources;
+    vector<int> targets;
+    for (int u = 0; u < table.size(); u++) {
+        if (table.get(u, from) + weight < table.get(u, to)) sources.push_back(u);
+    }
+    for (int v = 0; v < table.size(); v++) {
+        if (weight + table.get(to, v) < table.get(from, v)) targets.push_back(v);
+    }
+
+    for (int u : sources) {
+        double viaEdge = table.get(u, from) + weight;
+        int hop = u == from ? to : nextHop.get(u, from);
+        for (int v : targets) {
+            double cost = viaEdge + table.get(to, v);
+            if (cost < table.get(u, v)) {
+                table.set(u, v, cost);
+                nextHop.set(u, v, hop);
+            }
+        }
+    }
+}
+
+int Map::getEdgeCount() const {
+    return edgeTargets.size();
+}
+
+size_t Map::memoryBytes() const {
+    size_t bytes = (edgeOffsets.size() + edgeTargets.size()) * sizeof(int) + edgeWeights.size() * sizeof(double);
+    bytes += distanceTable.memoryBytes();
+    bytes += nextHop.memoryBytes();
+    bytes += hierarchy.memoryBytes();
+    bytes += landmarks.memoryBytes();
+    bytes += edgeProfile.size() * sizeof(int);
+    for (const TravelTimeProfile& profile : profiles) {
+        bytes += profile.memoryBytes();
+    }
+    return bytes;
 }
 
 int Map::GetMap_pos(int crt, int trg) {
-    return map_pos[trg][crt];
+    if (mode == MAP_EUCLIDEAN) {
+        return nodes[crt].calculateDistance(nodes[trg]);
+    }
+    if (crt == trg) return 0;
+    if (crt >= graphNodeCount) return -1;
+
+    auto first = edgeTargets.begin() + edgeOffsets[crt];
+    auto last = edgeTargets.begin() + edgeOffsets[crt + 1];
+    auto it = lower_bound(first, last, trg);
+    if (it == last || *it != trg) return -1;
+
+    return edgeWeights[it - edgeTargets.begin()];
 }
 
 double Map::GetMap_cost(int crt,int trg) const {
-    return map_cost[trg][crt];
+    if (mode == MAP_EUCLIDEAN) {
+        return nodes[crt].calculateDistance(nodes[trg]);
+    }
+    if (crt == trg) return 0;
+    if (crt >= graphNodeCount || trg >= graphNodeCount) return INT_MAX;   //도로 그래프 구성 이후 추가된 노드
+
+    if (mode == MAP_ALL_PAIRS) {
+        return distanceTable.get(crt, trg);
+    }
+    if (mode == MAP_CONTRACTION_HIERARCHY && crt < hierarchy.getNodeCount() && trg < hierarchy.getNodeCount()) {
+        return hierarchy.query(crt, trg);
+    }
+
+    return astar(crt, trg);
 }
 
-void Map::loop_cost(vector<int> check, double* temp, int node) {  //map_cost를 세팅하기위한 재귀함수
-    check.push_back(node);
+void Map::updateHeuristicScale(int from, int to, double weight) {
+    //직선거리보다 짧은 간선(고속도로 등)이 있으면 휴리스틱을 그 비율만큼 줄여야 최단거리를 과대평가하지 않는다
+    double straight = nodes[from].calculateDistance(nodes[to]);
+    if (straight > 0 && weight < heuristicScale * straight) {
+        heuristicScale = max(0.0, weight / straight);
+    }
+}
+
+double Map::astar(int source, int target) const {
+    int n = graphNodeCount;
+    SearchWorkspace& ws = search;
+    if ((int)ws.cost.size() < n) {   //노드가 늘었을 때만 재할당
+        ws.cost.resize(n);
+        ws.parent.resize(n);
+        ws.reached.resize(n, 0);
+        ws.closed.resize(n, 0);
+    }
+    if (++ws.stamp == 0) {   //stamp가 한 바퀴 돌면 표시를 전부 지우고 다시 시작
+        fill(ws.reached.begin(), ws.reached.end(), 0);
+        fill(ws.closed.begin(), ws.closed.end(), 0);
+        ws.stamp = 1;
+    }
+    unsigned int stamp = ws.stamp;
+    const Location& goal = nodes[target];
+    auto heuristic = [&](int v) { return heuristicScale * nodes[v].calculateDistance(goal); };
+    auto later = [](const pair<double, int>& a, const pair<double, int>& b) { return a.first > b.first; };
 
+    ws.open.clear();   //용량은 유지
+    ws.cost[source] = 0;
+    ws.parent[source] = -1;
+    ws.reached[source] = stamp;
+    ws.open.push_back({ heuristic(source), source });
 
-    int* crr = new int[nodes.size()];
-    for (int i = 0; i < nodes.size(); i++)
-    {
-        crr[i] = 0;
+    while (!ws.open.empty()) {
+        pop_heap(ws.open.begin(), ws.open.end(), later);
+        int u = ws.open.back().second;
+        ws.open.pop_back();
+
+        if (ws.closed[u] == stamp) continue;   //이미 더 짧은 경로로 확정된 노드
+        ws.closed[u] = stamp;
+        if (u == target) return ws.cost[u];
+
+        double d = ws.cost[u];
+        for (int e = edgeOffsets[u]; e < edgeOffsets[u + 1]; e++)
+        {
+            int v = edgeTargets[e];
+            double cost = d + edgeWeights[e];
+            if (ws.closed[v] == stamp || cost >= INT_MAX) continue;   //INT_MAX 이상은 도달 불가 (다익스트라와 같은 기준)
+            if (ws.reached[v] != stamp || cost < ws.cost[v]) {
+                ws.reached[v] = stamp;
+                ws.cost[v] = cost;
+                ws.parent[v] = u;
+                ws.open.push_back({ cost + heuristic(v), v });
+                push_heap(ws.open.begin(), ws.open.end(), later);
+            }
+        }
     }
+    return INT_MAX;
+}
 
-    for (int i = 0; i < (int)check.size(); i++)
-    {
-        crr[check.at(i)] = 1;
+int Map::addTravelTimeProfile(const TravelTimeProfile& profile) {
+    profiles.push_back(profile);
+    return profiles.size() - 1;
+}
+
+bool Map::setEdgeProfile(const Location& from, const Location& to, int profileId) {
+    if (profileId < -1 || profileId >= (int)profiles.size()) {
+        cerr << "Error: Unknown travel time profile " << profileId << endl;
+        return false;
+    }
+    if (!initialized || mode == MAP_EUCLIDEAN) {
+        cerr << "Error: Map::setEdgeProfile needs a road graph (SetMap/SetRoadMap)." << endl;
+        return false;
+    }
+    int u = from.node;
+    int v = to.node;
+    int position = (u >= 0 && u < graphNodeCount && v >= 0 && v < graphNodeCount) ? findEdge(u, v) : -1;
+    if (position < 0) {
+        cerr << "Error: Road edge " << u << " -> " << v << " does not exist." << endl;
+        return false;
+    }
+    if (profileId >= 0 && !profiles[profileId].isFifoFor(edgeWeights[position])) {
+        cerr << "Error: Travel time profile " << profileId << " drops too fast for road " << u << " -> " << v << " (FIFO)." << endl;
+        return false;
     }
 
-    for (int i = 0; i < nodes.size(); i++)
-    {
-        if (crr[i] == 1 || map_pos[node][i] < 0)continue;
+    if (edgeProfile.empty()) {
+        edgeProfile.assign(edgeTargets.size(), -1);
+    }
+    edgeProfile[position] = profileId;
+    updateMinProfileFactor();
+    return true;
+}
+
+bool Map::setDefaultProfile(int profileId) {
+    if (profileId < -1 || profileId >= (int)profiles.size()) {
+        cerr << "Error: Unknown travel time profile " << profileId << endl;
+        return false;
+    }
+    if (profileId >= 0) {
+        if (!profiles[profileId].isFifoFor(longestRoad())) {   //가장 긴 도로 기준으로 FIFO 확인
+            cerr << "Error: Travel time profile " << profileId << " drops too fast for the longest road (FIFO)." << endl;
+            return false;
+        }
+    }
 
+    defaultProfile = profileId;
+    updateMinProfileFactor();
+    return true;
+}
 
-        double cost = temp[node] + map_pos[node][i];
-        if (cost < temp[i]) {
-            temp[i] = cost;
-            loop_cost(check, temp, i);
+double Map::longestRoad() const {
+    double longest = 0;
+    if (mode == MAP_EUCLIDEAN) {   //직선 도로는 노드들을 감싸는 사각형의 대각선이 가장 길다
+        if (!nodes.empty()) longest = Location(minNodeX, minNodeY).calculateDistance(Location(maxNodeX, maxNodeY));
+    }
+    else {
+        for (double weight : edgeWeights) {
+            if (weight < INT_MAX) longest = max(longest, weight);
         }
     }
+    return longest;
+}
 
-    delete[] crr;
+bool Map::isFifoRoad(int position, double weight) const {
+    if (weight >= INT_MAX) return true;   //도달 불가 도로는 지나가지 않음
+    int profileId = (position < 0 || edgeProfile.empty()) ? -1 : edgeProfile[position];
+    if (profileId < 0) profileId = defaultProfile;
+    return profileId < 0 || profiles[profileId].isFifoFor(weight);
 }
 
-Location  Map::find_route(const Location& crt, const Location& trg) {
-    int crtNode = crt.node;
-    int trgNode = trg.node;
+void Map::recheckDefaultProfile() {
+    if (defaultProfile < 0 || profiles[defaultProfile].isFifoFor(longestRoad())) return;
+    cerr << "Error: Travel time profile " << defaultProfile << " drops too fast for the longest road (FIFO), default profile cleared." << endl;
+    defaultProfile = -1;
+    updateMinProfileFactor();
+}
+
+bool Map::hasTravelTimeProfiles() const {
+    if (defaultProfile >= 0) return true;
+    for (int profileId : edgeProfile) {
+        if (profileId >= 0) return true;
+    }
+    return false;
+}
 
-    double min = INT_MAX;
-    int result = -1;
+void Map::updateMinProfileFactor() {
+    //프로필 없는 도로는 1배이므로 1을 넘지 않게
+    minProfileFactor = 1.0;
+    costVersion++;   //프로필이 바뀌면 시간대별 소요시간도 바뀜
+    if (defaultProfile >= 0) minProfileFactor = min(minProfileFactor, profiles[defaultProfile].getMinFactor());
+    for (int profileId : edgeProfile) {
+        if (profileId >= 0) minProfileFactor = min(minProfileFactor, profiles[profileId].getMinFactor());
+    }
+}
+
+double Map::edgeTravelTime(int position, double weight, double time) const {
+    int profileId = edgeProfile.empty() ? -1 : edgeProfile[position];
+    if (profileId < 0) profileId = defaultProfile;
+    if (profileId < 0) return weight;
+    return weight * profiles[profileId].factorAt(time);
+}
+
+double Map::GetMap_cost(int crt, int trg, double departureTime) const {
+    if (!hasTravelTimeProfiles()) return GetMap_cost(crt, trg);
+    if (crt == trg) return 0;
+    if (mode == MAP_EUCLIDEAN) {   //직선 도로 하나로 감 (모든 도로가 같은 프로필이므로 돌아가도 이득이 거의 없음)
+        return nodes[crt].calculateDistance(nodes[trg]) * profiles[defaultProfile].factorAt(departureTime);
+    }
+    if (crt >= graphNodeCount || trg >= graphNodeCount) return INT_MAX;
+    return timeDependentSearch(crt, trg, departureTime);
+}
+
+double Map::timeDependentSearch(int source, int target, double departureTime) const {
+    //FIFO가 보장되면 각 노드의 가장 이른 도착 시각만 기억하는 다익스트라로 정확한 답이 나온다.
+    //휴리스틱은 직선거리 * heuristicScale * (가장 작은 배율) 이라 어떤 시각의 소요시간보다도 크지 않다
+    int n = graphNodeCount;
+    SearchWorkspace& ws = search;
+    if ((int)ws.cost.size() < n) {
+        ws.cost.resize(n);
+        ws.parent.resize(n);
+        ws.reached.resize(n, 0);
+        ws.closed.resize(n, 0);
+    }
+    if (++ws.stamp == 0) {
+        fill(ws.reached.begin(), ws.reached.end(), 0);
+        fill(ws.closed.begin(), ws.closed.end(), 0);
+        ws.stamp = 1;
+    }
+    unsigned int stamp = ws.stamp;
+    const Location& goal = nodes[target];
+    double scale = heuristicScale * minProfileFactor;
+    auto heuristic = [&](int v) { return scale * nodes[v].calculateDistance(goal); };
+    auto later = [](const pair<double, int>& a, const pair<double, int>& b) { return a.first > b.first; };
+
+    ws.open.clear();
+    ws.cost[source] = 0;   //출발 후 경과 시간
+    ws.parent[source] = -1;
+    ws.reached[source] = stamp;
+    ws.open.push_back({ heuristic(source), source });
+
+    while (!ws.open.empty()) {
+        pop_heap(ws.open.begin(), ws.open.end(), later);
+        int u = ws.open.back().second;
+        ws.open.pop_back();
 
-    for (int i = 0; i < nodes.size(); i++)
+        if (ws.closed[u] == stamp) continue;
+        ws.closed[u] = stamp;
+        if (u == target) return ws.cost[u];
+
+        double elapsed = ws.cost[u];
+        for (int e = edgeOffsets[u]; e < edgeOffsets[u + 1]; e++)
+        {
+            int v = edgeTargets[e];
+            if (ws.closed[v] == stamp || edgeWeights[e] >= INT_MAX) continue;
+            double cost = elapsed + edgeTravelTime(e, edgeWeights[e], departureTime + elapsed);
+            if (cost >= INT_MAX) continue;
+            if (ws.reached[v] != stamp || cost < ws.cost[v]) {
+                ws.reached[v] = stamp;
+                ws.cost[v] = cost;
+                ws.parent[v] = u;
+                ws.open.push_back({ cost + heuristic(v), v });
+                push_heap(ws.open.begin(), ws.open.end(), later);
+            }
+        }
+    }
+    return INT_MAX;
+}
+
+int Map::nodeOf(const Location& location) const {
+    if (location.node >= 0 && location.node < (int)nodes.size()) return location.node;
+    return findNode(location.getX(), location.getY());
+}
+
+double Map::calculateShortestDistance(const Location& from, const Location& to) const {
+    int crt = nodeOf(from);
+    int trg = nodeOf(to);
+    if (crt < 0 || trg < 0) {
+        cerr << "Error: Location (" << (crt < 0 ? from : to).getX() << ", " << (crt < 0 ? from : to).getY() << ") is not on the map." << endl;
+        return INT_MAX;
+    }
+    return GetMap_cost(crt, trg);
+}
+
+void Map::dijkstra(int source, double* dist, int target, int* parent, const char* stopMarks, int stopCount) const {   //이진 힙 기반 다익스트라, 도달 불가 노드는 INT_MAX
+    int n = graphNodeCount;
+    for (int i = 0; i < n; i++)
     {
-        if (map_pos[i][crtNode] <= 0) continue;
+        dist[i] = INT_MAX;
+    }
+    dist[source] = 0;
+    if (parent != nullptr) {
+        fill(parent, parent + n, -1);
+    }
+
+    priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> pq;
+    pq.push({ 0.0, source });
+
+    while (!pq.empty()) {
+        double d = pq.top().first;
+        int u = pq.top().second;
+        pq.pop();
+
+        if (d > dist[u]) continue;   //이미 더 짧은 경로로 확정된 노드
+        if (u == target) break;
+        if (stopMarks != nullptr && stopMarks[u] && --stopCount == 0) break;
 
-        double cost = map_pos[i][crtNode] + map_cost[trgNode][i];
-        if (cost < min) {
-            min = cost;
-            result = i;
+        for (int e = edgeOffsets[u]; e < edgeOffsets[u + 1]; e++)
+        {
+            int v = edgeTargets[e];
+            double cost = d + edgeWeights[e];
+            if (cost < dist[v]) {
+                dist[v] = cost;
+                if (parent != nullptr) parent[v] = u;
+                pq.push({ cost, v });
+            }
         }
     }
+}
+
+int Map::nextNode(int crt, int trg) const {
+    if (crt == trg) return trg;
+    if (mode == MAP_EUCLIDEAN) return trg;   //완전 그래프에서는 목적지로 바로 가는 길이 항상 최단 경로
+    if (crt >= graphNodeCount || trg >= graphNodeCount) return -1;
+    if (mode == MAP_ALL_PAIRS) {
+        return nextHop.get(crt, trg);
+    }
 
-    return nodes[result];
+    long long key = ((long long)crt << 32) | (unsigned int)trg;
+    auto cached = routeCache.find(key);
+    if (cached != routeCache.end()) return cached->second;
 
+    //한 번 경로를 구하면 경로 위 모든 노드의 다음 노드를 같이 저장 (최단경로의 부분경로도 최단경로)
+    if (astar(crt, trg) >= INT_MAX) return -1;
+
+    for (int v = trg; v != crt; v = search.parent[v]) {
+        routeCache[((long long)search.parent[v] << 32) | (unsigned int)trg] = v;
+    }
+    return routeCache[key];
 }
 
+vector<Location> Map::getShortestPath(const Location& from, const Location& to) const {
+    vector<Location> path;
+    int crt = nodeOf(from);
+    int trg = nodeOf(to);
+    if (crt < 0 || trg < 0) return path;
+
+    if (mode == MAP_ROAD_GRAPH || mode == MAP_CONTRACTION_HIERARCHY) {   //A* 부모 포인터를 목적지에서 거꾸로 따라감
+        if (crt == trg) return { nodes[crt] };
+        if (crt >= graphNodeCount || trg >= graphNodeCount || astar(crt, trg) >= INT_MAX) return path;
+        for (int v = trg; v != -1; v = search.parent[v]) {
+            path.push_back(nodes[v]);
+        }
+        reverse(path.begin(), path.end());
+        return path;
+    }
+
+    if (nextNode(crt, trg) == -1) return path;
+    path.push_back(nodes[crt]);
+    while (crt != trg) {
+        crt = nextNode(crt, trg);
+        path.push_back(nodes[crt]);
+    }
+    return path;
+}
+
+Location  Map::find_route(const Location& crt, const Location& trg) {
+    int next = nextNode(crt.node, trg.node);
+    return nodes[next == -1 ? crt.node : next];   //갈 수 있는 길이 없으면 제자리
+}
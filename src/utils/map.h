@@ -3,7 +3,20 @@
 
 #include <iostream>
 #include <vector>
+#include <utility>
+#include <unordered_map>
+#include <memory>
+#include <string>
 #include "location.h"
+#include "contraction_hierarchy.h"
+#include "distance_table.h"
+#include "next_hop_table.h"
+#include "thread_pool.h"
+#include "floyd_warshall.h"
+#include "mapped_file.h"
+#include "travel_time_profile.h"
+#include "landmark_bounds.h"
+#include "distance_kernel.h"
 
 enum ItemType {
     ORDERER,
@@ -11,6 +24,57 @@ enum ItemType {
     STORE
 };
 
+enum MapMode {
+    MAP_ALL_PAIRS,      // 도로 그래프 + 전체 최단거리 테이블
+    MAP_EUCLIDEAN,      // 모든 노드가 직선으로 연결된 완전 그래프. 행렬 없이 좌표로 바로 거리 계산
+    MAP_ROAD_GRAPH,     // 도로 그래프만 보관하고 최단거리는 질의할 때마다 계산 (NxN 테이블 없음)
+    MAP_CONTRACTION_HIERARCHY   // 도로 그래프를 Contraction Hierarchy로 전처리해 두고 두 노드 사이 거리만 빠르게 계산 (NxN 테이블 없음)
+};
+
+// MAP_ALL_PAIRS 거리 테이블 계산 방식
+enum AllPairsBackend {
+    ALL_PAIRS_DIJKSTRA,         // 출발점마다 다익스트라 (간선이 적은 도로망에 유리)
+    ALL_PAIRS_FLOYD_WARSHALL    // 블록 단위 Floyd–Warshall (수천 개 노드의 조밀한 그래프에 유리, 임시로 NxN double 행렬 사용)
+};
+
+// Map::reorderNodes가 노드 번호를 매기는 공간 채움 곡선
+enum NodeOrder {
+    NODE_ORDER_HILBERT,   // 힐베르트 곡선 (번호가 가까우면 위치도 가까움, 국소성이 가장 좋음)
+    NODE_ORDER_MORTON     // Z-order (좌표 비트를 번갈아 섞기만 해서 계산이 싸지만 사분면 경계에서 크게 튐)
+};
+
+// 도로 그래프의 간선 하나 (nodes[from] 에서 nodes[to] 로 가는 길, weight 만큼의 시간 소모)
+struct RoadEdge {
+    int from;
+    int to;
+    double weight;
+};
+
+// 도로 그래프를 간선 단위로 쌓는 빌더 (노드 번호는 Map::addLocation이 매긴 번호).
+// 간선 목록만 들고 있으므로 메모리는 O(E)이고, Map::SetRoadMap(move(builder))로 넘기면
+// 간선 버퍼가 복사 없이 Map으로 옮겨져 CSR로 바뀐 뒤 해제된다. 넘긴 뒤 빌더는 비어 있다.
+class RoadGraphBuilder {
+public:
+    void reserve(size_t edgeCount);
+    void addEdge(int from, int to, double weight);   // from -> to 일방통행
+    void addRoad(int a, int b, double weight);       // 양방향 도로
+    size_t edgeCount() const;
+    vector<RoadEdge> release();   // 모은 간선을 꺼내고 빌더를 비움
+
+private:
+    vector<RoadEdge> edges;
+};
+
+// Map::GetMap_costTable 결과: sources x targets 최단거리를 행 우선으로 한 덩어리에 저장
+struct CostMatrix {
+    int rows = 0;
+    int cols = 0;
+    vector<double> costs;   // costs[i * cols + j] = sources[i] -> targets[j], 길이없으면 INT_MAX
+
+    double at(int i, int j) const { return costs[(size_t)i * cols + j]; }
+    const double* row(int i) const { return costs.data() + (size_t)i * cols; }
+};
+
 class MapItem {
 public:
     MapItem(const Location& location, ItemType itemType, int id);
@@ -36,13 +100,41 @@ public:
     ~Map();
 
     void addItem(const MapItem& item);
-    void addLocation(Location& pos);
+    bool moveItem(ItemType itemType, int id, const Location& location);   //종류와 ID가 같은 아이템의 위치 변경, 없으면 false
+    void addLocation(Location& pos);   //pos.node에 노드 번호 기록. 같은 좌표가 이미 있으면 그 노드를 재사용
+    int findNode(int x, int y) const;  //좌표에 해당하는 노드 번호, 없으면 -1
     vector<MapItem> getAllItems() const;
 
-    double calculateShortestDistance(const Location& from, const Location& to) const;   // 최단 거리 계산 (다익스트라)
-    vector<Location> getShortestPath(const Location& from, const Location& to) const;
+    double calculateShortestDistance(const Location& from, const Location& to) const;   // 최단 거리 계산 (도로 그래프에서는 A*), 길이없으면 INT_MAX
+    vector<Location> getShortestPath(const Location& from, const Location& to) const;   // from부터 to까지 거치는 노드 (양 끝 포함), 길이없으면 빈 벡터
+
+    //도로 간선 추가 (SetMap/SetRoadMap 이후). 초기화 후 addLocation으로 붙인 노드를 도로에 연결할 때 사용
+    //MAP_ALL_PAIRS에서는 새 간선으로 짧아지는 행/열만 갱신하고, 이미 있는 도로는 더 짧아질 때만 바뀐다.
+    void addEdge(const Location& from, const Location& to, double weight);
 
-    void addEdge(const Location& from, const Location& to, double weight);              // 그래프 간선 추가
+    //이미 있는 도로의 소요시간 변경 (정체, 통제 등. INT_MAX 이상이면 사실상 통행 불가). 도로가 없으면 false
+    //MAP_ALL_PAIRS에서는 영향받는 부분만 고친다: 짧아진 간선은 addEdge와 같은 방식으로 완화하고,
+    //길어진 간선은 그 간선을 최단경로에 쓰던 출발점의 행만 다시 계산한다. MAP_CONTRACTION_HIERARCHY는 다시 전처리
+    bool updateEdgeWeight(const Location& from, const Location& to, double weight);
+    int updateEdgeWeights(const vector<RoadEdge>& changes);   //여러 도로를 한 번에 변경, 실제로 바뀐 도로 수 반환 (없는 도로는 건너뜀)
+
+    //노드 번호를 좌표의 공간 채움 곡선 순서로 다시 매김. 가까운 노드끼리 거리 테이블의 행/열과 CSR 행이 붙어 있게 되어
+    //근처 노드 사이 조회가 같은 캐시 라인을 쓴다. 반환값은 newId[기존 번호] = 새 번호이고,
+    //Map 밖에서 Location.node를 들고 있는 쪽은 이 값으로 번호를 바꿔야 한다 (DeliverySystem::reorderNodes).
+    //도로 그래프, 거리 테이블, 다음 노드 행렬은 다시 계산하지 않고 옮기며 CH만 다시 전처리한다.
+    vector<int> reorderNodes(NodeOrder order = NODE_ORDER_HILBERT);
+
+    //시간대별 소요시간 (시각 단위는 소요시간 단위와 같다고 봄). 프로필을 등록하고 도로에 번호를 지정하면
+    //GetMap_cost(crt, trg, departureTime)이 출발 시각을 반영한 최단 소요시간을 계산한다 (시간 의존 다익스트라).
+    //프로필 지정은 도로 그래프 기준이라 SetMap/SetRoadMap을 다시 하면 지워진다.
+    int addTravelTimeProfile(const TravelTimeProfile& profile);   //프로필 번호 반환
+    //from -> to 도로에 프로필 지정 (-1이면 고정 소요시간). 늦게 출발한 차가 먼저 도착하게 되는 (FIFO가 깨지는) 조합이면 false
+    bool setEdgeProfile(const Location& from, const Location& to, int profileId);
+    //프로필을 따로 지정하지 않은 모든 도로에 적용 (-1이면 없음). MAP_EUCLIDEAN의 직선 도로에도 적용된다.
+    //이후 도로가 길어져 FIFO가 깨지면 updateEdgeWeights/addEdge는 그 변경을 거부하고,
+    //SetMap/SetRoadMap/SetEuclideanMap이나 직선 맵의 addLocation으로 가장 긴 도로가 길어지면 기본 프로필이 해제된다
+    bool setDefaultProfile(int profileId);
+    bool hasTravelTimeProfiles() const;
     
     // Getters
     int getWidth() const;
@@ -53,24 +145,139 @@ public:
     //arr는 MapItem끼리 연결되있는지의 여부를 1과0의 정보로 받음 
     //예시) arr[1][3]=0 이면 items[3] 에서 items[1]로 가는 길은 없다는 의미 이다.
     //반대로 arr[3][1]=1 이면 items[1] 에서 items[3]로 가는 길은 있다는 의미 이다.
+    //arr가 전부 1이면 (완전 그래프) 행렬을 만들지 않고 MAP_EUCLIDEAN 모드로 전환한다.
+    //arr(각 행과 행 배열)는 SetMap이 delete[] 하므로 호출한 쪽에서는 더 이상 쓰면 안 된다.
+    //NxN 행렬이 필요 없는 RoadGraphBuilder + SetRoadMap 쪽을 권장
     void SetMap(int** arr);
+    //간선 목록으로 도로 그래프(CSR)를 구성. roadMode로 거리 계산 방식을 고른다.
+    //MAP_ALL_PAIRS: 거리 테이블 전체 계산 / MAP_ROAD_GRAPH: 질의마다 A* / MAP_CONTRACTION_HIERARCHY: CH 전처리 후 질의
+    //const& 버전은 간선을 복사하고, && 버전과 빌더 버전은 넘겨받은 버퍼를 CSR로 바꾼 뒤 해제한다 (추가 메모리 O(E))
+    void SetRoadMap(const vector<RoadEdge>& edges, MapMode roadMode = MAP_ALL_PAIRS);
+    void SetRoadMap(vector<RoadEdge>&& edges, MapMode roadMode = MAP_ALL_PAIRS);
+    void SetRoadMap(RoadGraphBuilder&& builder, MapMode roadMode = MAP_ALL_PAIRS);
+    void SetEuclideanMap();   //모든 노드가 서로 직선으로 연결된 맵으로 설정 (행렬 할당 없음, 이후 추가되는 노드도 바로 사용 가능)
+    //MAP_ALL_PAIRS 거리 테이블의 원소 형식 (DISTANCE_UINT16이면 거리 = 저장값 * scale). 이미 테이블이 있으면 새 형식으로 다시 계산
+    void setDistanceStorage(DistanceStorage storage, double scale = 1.0);
+    DistanceStorage getDistanceStorage() const;
+    //MAP_ALL_PAIRS 테이블 계산 방식. 이미 테이블이 있으면 새 방식으로 다시 계산
+    void setAllPairsBackend(AllPairsBackend backend);
+    AllPairsBackend getAllPairsBackend() const;
+    //MAP_ALL_PAIRS 테이블 캐시 폴더. 지정하면 좌표/간선/저장 형식이 같은 맵은 테이블을 다시 계산하지 않고
+    //폴더의 캐시 파일을 읽기 전용으로 mmap해서 복사 없이 사용 (파일 이름은 그래프 해시, 없으면 계산 후 저장). 빈 문자열이면 사용 안 함
+    void setDistanceCacheDirectory(const string& directory);
+    bool isDistanceTableCached() const;   //현재 거리 테이블이 캐시 파일에서 읽은 것인지
+    string getDistanceCachePath() const;  //지금의 도로 그래프에 해당하는 캐시 파일 경로 (도로 그래프 구성 이후에만 의미 있음, 캐시 디렉터리가 없으면 빈 문자열)
+    //MAP_ROAD_GRAPH/CH에서 lowerBound에 쓸 ALT 랜드마크 수 (0이면 직선거리 하한만 사용, 기본 8)
+    void setLandmarkCount(int count);
+    int getLandmarkCount() const;
+    //도로 그래프가 바뀌어 랜드마크 거리가 무효가 되었으면 다시 계산 (배차 전에 호출. 이미 유효하면 아무것도 안 함)
+    void prepareLowerBounds();
+    //MAP_ALL_PAIRS 테이블을 계산할 스레드 수 (0이면 하드웨어 스레드 수). 스레드 수와 관계없이 결과는 같다
+    void setThreadCount(int threads);
+    int getThreadCount() const;
+    MapMode getMode() const;
+    bool isInitialized() const;   //SetMap 또는 SetEuclideanMap이 호출되었는지 여부
+    int getEdgeCount() const;     //도로 그래프의 간선 수
+    size_t memoryBytes() const;   //거리 계산용 자료구조(도로 그래프, 거리 테이블, CH)가 차지하는 메모리 (mmap한 캐시 파일 제외)
     int GetMap_pos(int crt, int trg); //currentPos 에서 targetPos까지의 직접적인 거리. 길이없으면 -1 반환
-    double GetMap_cost(int crt,int trg) const;
+    double GetMap_cost(int crt,int trg) const;   //crt에서 trg까지의 최단거리. 길이없으면 INT_MAX 반환
+    //departureTime에 crt를 출발했을 때 trg까지의 최단 소요시간. 프로필이 없으면 GetMap_cost(crt, trg)와 같음
+    double GetMap_cost(int crt, int trg, double departureTime) const;
+    //sources의 각 노드에서 targets의 각 노드까지 최단거리 표 (GetMap_cost(sources[i], targets[j])와 같은 값).
+    //MAP_CONTRACTION_HIERARCHY는 bucket 방식 many-to-many, MAP_ROAD_GRAPH는 출발점마다 목적지를 모두 찾을 때까지 다익스트라 한 번,
+    //MAP_EUCLIDEAN은 DistanceKernel로 좌표에서 바로 계산.
+    //출발점 단위로 병렬 계산하며 시간대별 프로필은 반영하지 않는다 (고정 소요시간 기준)
+    CostMatrix GetMap_costTable(const vector<int>& sources, const vector<int>& targets) const;
+    //crt에서 trg까지 소요시간의 하한 (어떤 출발 시각의 GetMap_cost보다도 크지 않음). 탐색 없이 O(랜드마크 수)
+    //MAP_EUCLIDEAN/MAP_ALL_PAIRS는 정확한 거리, 도로 그래프는 직선거리와 ALT 랜드마크 하한 중 큰 값
+    double lowerBound(int crt, int trg) const;
+    //GetMap_cost / lowerBound를 여러 스레드에서 동시에 불러도 되는지 (탐색 작업 공간, 경로 캐시를 건드리지 않는 경우:
+    //MAP_EUCLIDEAN, 시간대별 프로필이 없는 MAP_ALL_PAIRS). 그 사이에 맵을 바꾸는 호출이 없어야 함
+    bool isConcurrentQuerySafe() const;
+    //거리 계산 결과가 바뀔 수 있는 변경(도로 구성/가중치, 노드 번호, 테이블 형식, 프로필)마다 늘어나는 번호.
+    //바깥에서 거리를 기억해 둘 때 이 값이 같으면 그대로 써도 된다
+    unsigned long long getCostVersion() const;
 
     Location find_route(const Location& crt, const Location& trg); //crt에 위치했을때 trg로 가려면 어느 노드로 가야하는지 반환
 
-    double** map_pos;  //map의 연결정보를 담은 행렬그래프.   map[1][3]=5 이면 items[3] 에서 items[1]로 가는 길은 5의 시간을 소모한다는 의미이다.
-    double** map_cost;   //items[j]에서 출발해서 items[i]로 도착하기위한 최단시간을 map_cost[i][j]로 저장한 행렬
 
     vector<Location> nodes;
 
 private:
     int width;
     int height;
+    MapMode mode;
+    bool initialized;
     vector<MapItem> items;
-    // map<Location, vector<pair<Location, double>>> adjacencyList;     
-    
-    void loop_cost(vector<int> check, double* temp, int node);// 그래프 표현: 인접 리스트
+    unordered_map<long long, int> nodeIndex;   //좌표 -> 노드 번호 (같은 위치의 주문자/가게/배달지가 한 노드를 공유)
+    DistanceTable distanceTable;  // items[j]에서 items[i]까지의 최단시간을 (j, i)에 저장 (MAP_ALL_PAIRS에서만 채움)
+    NextHopTable nextHop;         // (u, t) : u에서 t로 가는 최단경로의 다음 노드 (-1이면 길 없음, MAP_ALL_PAIRS에서만 채움)
+    mutable unordered_map<long long, int> routeCache;   // MAP_ROAD_GRAPH/CH에서 한 번 찾은 경로의 (노드, 목적지) -> 다음 노드
+
+    // 도로 그래프 (CSR): 노드 u에서 나가는 간선은 edgeTargets/edgeWeights의 [edgeOffsets[u], edgeOffsets[u+1]) 구간
+    int graphNodeCount;
+    vector<int> edgeOffsets;
+    vector<int> edgeTargets;
+    vector<double> edgeWeights;
+
+    ContractionHierarchy hierarchy;   // MAP_CONTRACTION_HIERARCHY 모드에서만 구성
+    LandmarkBounds landmarks;         // MAP_ROAD_GRAPH/CH에서 prepareLowerBounds가 구성, 간선이 짧아지거나 추가되면 비움
+    int landmarkCount;
+
+    AllPairsBackend allPairsBackend;
+    string distanceCacheDirectory;
+    unique_ptr<MappedFile> distanceCache;   // 매핑된 캐시 파일 (distanceTable과 nextHop이 이 안을 가리킴)
+    vector<TravelTimeProfile> profiles;
+    vector<int> edgeProfile;   // CSR 간선 순서와 같음 (-1 = 기본 프로필), 도로별 지정이 없으면 비어 있음
+    int defaultProfile;
+    double minProfileFactor;   // 사용 중인 프로필 배율의 최솟값 (시간 의존 A* 휴리스틱용)
+    int minNodeX, minNodeY, maxNodeX, maxNodeY;   // 노드들을 감싸는 사각형 (직선 도로의 최대 길이 = 대각선)
+
+    int threadCount;
+    mutable unique_ptr<ThreadPool> pool;   // threadPool()로 처음 쓸 때 생성
+
+    // A* 탐색 작업 공간. 노드 수만큼 한 번만 할당하고 stamp로 초기화를 대신해 질의마다 메모리 할당이 없다
+    struct SearchWorkspace {
+        vector<double> cost;
+        vector<int> parent;
+        vector<unsigned int> reached;   // reached[v] == stamp 이면 이번 탐색의 cost/parent가 유효
+        vector<unsigned int> closed;    // closed[v] == stamp 이면 이번 탐색에서 확정된 노드
+        vector<pair<double, int>> open; // (cost + heuristic, node) 최소 힙
+        unsigned int stamp = 0;
+    };
+    mutable SearchWorkspace search;
+    double heuristicScale;   // 직선거리에 곱해도 어떤 간선 가중치보다 크지 않은 비율 (A* 휴리스틱이 최단거리를 넘지 않도록)
+    unsigned long long costVersion;   // getCostVersion
+
+    ThreadPool& threadPool() const;
+    void buildRoadGraph(vector<RoadEdge>&& edges);
+    void buildAllPairs();
+    void buildAllPairsDijkstra();
+    void computeRows(const vector<int>& sources);   // sources의 거리 테이블/다음 노드 행을 다익스트라로 다시 계산 (병렬)
+    int findEdge(int from, int to) const;           // CSR에서 from -> to 간선 위치, 없으면 -1
+    double distanceTolerance(double distance) const; // 저장 형식의 반올림 오차를 감안한 비교 여유
+    void buildAllPairsFloydWarshall();
+    unsigned long long graphHash() const;   // 좌표, 간선, 테이블 저장 형식으로 만든 캐시 키
+    bool loadDistanceCache();
+    void saveDistanceCache() const;
+    void releaseDistanceCache();
+    void ownNextHop();   // 매핑된 다음 노드 행렬을 nextHop 자기 버퍼로 복사 (값을 바꾸기 전에 호출)
+    void releaseTables();
+    bool insertEdge(int from, int to, double weight);
+    void relaxInsertedEdge(int from, int to, double weight);
+    // source에서의 최단거리를 dist에 기록 (이진 힙). target에 도달하거나, stopMarks[v]가 1인 노드를 stopCount개 모두 확정하면 중단
+    void dijkstra(int source, double* dist, int target = -1, int* parent = nullptr, const char* stopMarks = nullptr, int stopCount = 0) const;
+    void fillNextHopRow(int source, const int* parent, const double* dist, int* row) const;   // row[0..N)에 source 행 기록
+    int nextNode(int crt, int trg) const;   // crt에서 trg로 가는 최단경로의 다음 노드, 길이없으면 -1
+    double astar(int source, int target) const;   // 도로 그래프 A*, 경로는 search.parent에 남는다. 길이없으면 INT_MAX
+    double timeDependentSearch(int source, int target, double departureTime) const;   // 시간 의존 A*, 소요시간 반환
+    double edgeTravelTime(int position, double weight, double time) const;   // time에 출발할 때 CSR 간선 position의 소요시간
+    void updateMinProfileFactor();
+    double longestRoad() const;   // 기본 프로필의 FIFO 확인 기준이 되는 가장 긴 도로
+    bool isFifoRoad(int position, double weight) const;   // CSR 간선 position (-1이면 새 도로)이 weight일 때 적용될 프로필이 FIFO인지
+    void recheckDefaultProfile();   // 도로가 길어질 수 있는 변경 뒤 기본 프로필을 다시 확인해 FIFO가 깨지면 해제
+    void updateHeuristicScale(int from, int to, double weight);
+    int nodeOf(const Location& location) const;   // location.node가 없으면 좌표로 찾음
 };
 
 
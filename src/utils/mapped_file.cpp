@@ -0,0 +1,40 @@
+#include "mapped_file.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+MappedFile::MappedFile() : address(nullptr), length(0) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   //매핑은 파일 디스크립터를 닫아도 유지됨
+    if (mapped == MAP_FAILED) return false;
+
+    address = mapped;
+    length = info.st_size;
+    return true;
+}
+
+void MappedFile::close() {
+    if (address != nullptr) {
+        munmap(address, length);
+    }
+    address = nullptr;
+    length = 0;
+}
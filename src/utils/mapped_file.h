@@ -0,0 +1,30 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+using namespace std;
+
+// 읽기 전용으로 메모리에 매핑한 파일 (POSIX mmap). 내용은 필요할 때 페이지 단위로 읽히고 소멸 시 매핑 해제
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const string& path);   // 실패하면 false (파일 없음, 빈 파일 등)
+    void close();
+
+    const unsigned char* data() const { return static_cast<const unsigned char*>(address); }   // 페이지 경계에 정렬됨
+    size_t size() const { return length; }
+    bool isOpen() const { return address != nullptr; }
+
+private:
+    void* address;
+    size_t length;
+};
+
+#endif
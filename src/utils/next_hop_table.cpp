@@ -0,0 +1,140 @@
+#include "next_hop_table.h"
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <new>
+
+NextHopTable::NextHopTable()
+    : data(nullptr), owned(true), wide(false), tableSize(0), capacity(0) {}
+
+NextHopTable::~NextHopTable() {
+    clear();
+}
+
+void NextHopTable::reset(int size) {
+    clear();
+    if (size <= 0) return;
+
+    wide = !fitsNarrow(size);
+    capacity = paddedCapacity(size);
+    data = allocate(capacity);
+    tableSize = size;
+    fillRows(0, tableSize, 0, tableSize);
+}
+
+void NextHopTable::resize(int newSize) {
+    if (newSize <= tableSize) return;
+    if (data == nullptr) {
+        reset(newSize);
+        return;
+    }
+
+    bool newWide = wide || !fitsNarrow(newSize);
+    if (newSize > capacity || newWide != wide) {   // 용량을 두 배로 늘리거나 원소를 넓혀 새 버퍼로 행을 옮김
+        unsigned char* oldData = data;
+        bool oldOwned = owned;
+        bool oldWide = wide;
+        int oldCapacity = capacity;
+
+        wide = newWide;
+        int newCapacity = paddedCapacity(max(newSize, capacity * 2));
+        unsigned char* grown = allocate(newCapacity);
+        if (oldWide == wide) {
+            size_t rowBytes = (size_t)tableSize * elementSize();
+            for (int i = 0; i < tableSize; i++) {
+                memcpy(grown + (size_t)i * newCapacity * elementSize(), oldData + (size_t)i * oldCapacity * elementSize(), rowBytes);
+            }
+        }
+        else {   // uint16 -> int32
+            for (int i = 0; i < tableSize; i++) {
+                const uint16_t* source = reinterpret_cast<const uint16_t*>(oldData) + (size_t)i * oldCapacity;
+                for (int j = 0; j < tableSize; j++) {
+                    store(grown, (size_t)i * newCapacity + j, source[j] == UINT16_NONE ? -1 : source[j]);
+                }
+            }
+        }
+        if (oldOwned) free(oldData);
+        data = grown;
+        owned = true;
+        capacity = newCapacity;
+    }
+    else if (!owned) {
+        detach();
+    }
+
+    fillRows(0, tableSize, tableSize, newSize);
+    fillRows(tableSize, newSize, 0, newSize);
+    tableSize = newSize;
+}
+
+void NextHopTable::clear() {
+    if (owned) free(data);
+    data = nullptr;
+    owned = true;
+    tableSize = 0;
+    capacity = 0;
+}
+
+void NextHopTable::setRow(int from, const int* hops) {
+    for (int to = 0; to < tableSize; to++) {
+        set(from, to, hops[to]);
+    }
+}
+
+void NextHopTable::permute(const vector<int>& order, const vector<int>& newId) {
+    if (data == nullptr || (int)order.size() != tableSize) return;
+
+    unsigned char* permuted = allocate(capacity);   //attach 상태여도 원본은 건드리지 않고 새 버퍼에 모음
+    for (int i = 0; i < tableSize; i++) {
+        for (int j = 0; j < tableSize; j++) {
+            int hop = get(order[i], order[j]);
+            store(permuted, (size_t)i * capacity + j, hop >= 0 ? newId[hop] : -1);
+        }
+    }
+    if (owned) free(data);
+    data = permuted;
+    owned = true;
+}
+
+void NextHopTable::attach(const unsigned char* buffer, int size, int rowCapacity, int elementBytes) {
+    clear();
+    data = const_cast<unsigned char*>(buffer);   //owned가 false인 동안은 읽기만 함
+    owned = false;
+    wide = elementBytes == (int)sizeof(int32_t);
+    tableSize = size;
+    capacity = rowCapacity;
+}
+
+void NextHopTable::detach() {
+    if (owned) return;
+    unsigned char* copied = allocate(capacity);
+    memcpy(copied, data, (size_t)tableSize * rowBytes());
+    data = copied;
+    owned = true;
+}
+
+size_t NextHopTable::memoryBytes() const {
+    if (!owned) return 0;
+    return (size_t)capacity * capacity * elementSize();
+}
+
+int NextHopTable::paddedCapacity(int count) const {   // 행 시작이 항상 캐시 라인 경계에 오도록 원소 수를 올림
+    int perLine = CACHE_LINE / elementSize();
+    return (count + perLine - 1) / perLine * perLine;
+}
+
+unsigned char* NextHopTable::allocate(int rowCapacity) const {
+    size_t bytes = (size_t)rowCapacity * rowCapacity * elementSize();
+    bytes = (bytes + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    unsigned char* buffer = static_cast<unsigned char*>(aligned_alloc(CACHE_LINE, bytes));
+    if (buffer == nullptr) throw bad_alloc();
+    return buffer;
+}
+
+void NextHopTable::fillRows(int rowBegin, int rowEnd, int colBegin, int colEnd) {
+    for (int i = rowBegin; i < rowEnd; i++) {
+        for (int j = colBegin; j < colEnd; j++) {
+            store(data, (size_t)i * capacity + j, i == j ? i : -1);
+        }
+    }
+}
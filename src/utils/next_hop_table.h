@@ -0,0 +1,79 @@
+#ifndef NEXT_HOP_TABLE_H
+#define NEXT_HOP_TABLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+// NxN 다음 노드 테이블. (u, t)는 u에서 t로 가는 최단경로의 다음 노드, 길이 없으면 -1.
+// DistanceTable과 같이 한 번의 64바이트 정렬 할당에 행을 이어 붙이고, 행 간격은 캐시 라인 배수로 맞추며
+// 노드가 늘어나면 용량을 두 배씩 늘린다. 노드 번호가 65535 미만이면 2바이트, 아니면 4바이트 원소로 저장한다.
+// attach()로 외부의 읽기 전용 버퍼(매핑된 캐시 파일)를 복사 없이 쓸 수 있고, 값을 바꾸는 순간 자기 버퍼로 복사한다.
+class NextHopTable {
+public:
+    NextHopTable();
+    ~NextHopTable();
+
+    NextHopTable(const NextHopTable&) = delete;
+    NextHopTable& operator=(const NextHopTable&) = delete;
+
+    void reset(int size);       // size x size, 대각선은 자기 자신 / 나머지 -1로 초기화
+    void resize(int newSize);   // 기존 값 유지, 새 행/열은 -1 (대각선은 자기 자신). 2바이트로 부족해지면 4바이트로 넓힘
+    void clear();
+
+    inline int get(int from, int to) const;
+    inline void set(int from, int to, int hop);
+    void setRow(int from, const int* hops);   // hops[0..size) 를 from 행에 기록
+    void permute(const vector<int>& order, const vector<int>& newId);   // 새 (i, j) = newId[기존 (order[i], order[j])]
+
+    // buffer에 size개 행이 rowCapacity 간격으로 elementBytes(2 또는 4)바이트 원소로 들어있어야 함 (buffer는 detach/clear 전까지 유지)
+    void attach(const unsigned char* buffer, int size, int rowCapacity, int elementBytes);
+    const unsigned char* rowData(int from) const { return data + (size_t)from * rowBytes(); }
+    size_t rowBytes() const { return (size_t)capacity * elementSize(); }
+
+    // Getters
+    int size() const { return tableSize; }
+    int getCapacity() const { return capacity; }
+    int getElementBytes() const { return (int)elementSize(); }
+    bool isAttached() const { return data != nullptr && !owned; }
+    void detach();   // attach한 외부 버퍼 내용을 자기 버퍼로 복사 (여러 스레드가 행을 쓰기 전에 미리 호출)
+    size_t memoryBytes() const;   // 자기 버퍼 크기 = capacity x capacity 원소 (attach한 외부 버퍼는 제외)
+    static bool fitsNarrow(int size) { return size <= UINT16_NONE; }   // 노드 번호가 2바이트 원소에 들어가는지
+
+private:
+    static constexpr int CACHE_LINE = 64;
+    static constexpr uint16_t UINT16_NONE = 65535;
+
+    unsigned char* data;
+    bool owned;                 // false면 data는 attach한 외부 버퍼
+    bool wide;                  // true면 int32 원소, false면 uint16 원소 (65535 = 길 없음)
+    int tableSize;
+    int capacity;               // 한 행에 들어가는 원소 수 (stride)
+
+    size_t elementSize() const { return wide ? sizeof(int32_t) : sizeof(uint16_t); }
+    int paddedCapacity(int count) const;
+    unsigned char* allocate(int rowCapacity) const;
+    inline void store(unsigned char* buffer, size_t index, int hop) const;
+    void fillRows(int rowBegin, int rowEnd, int colBegin, int colEnd);   // -1로 채우고 대각선은 자기 자신
+};
+
+inline int NextHopTable::get(int from, int to) const {
+    size_t index = (size_t)from * capacity + to;
+    if (wide) return reinterpret_cast<const int32_t*>(data)[index];
+    uint16_t hop = reinterpret_cast<const uint16_t*>(data)[index];
+    return hop == UINT16_NONE ? -1 : hop;
+}
+
+inline void NextHopTable::store(unsigned char* buffer, size_t index, int hop) const {
+    if (wide) reinterpret_cast<int32_t*>(buffer)[index] = hop;
+    else reinterpret_cast<uint16_t*>(buffer)[index] = hop < 0 ? UINT16_NONE : (uint16_t)hop;
+}
+
+inline void NextHopTable::set(int from, int to, int hop) {
+    if (!owned) detach();
+    store(data, (size_t)from * capacity + to, hop);
+}
+
+#endif
@@ -0,0 +1,188 @@
+#include "spatial_grid.h"
+#include <climits>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include <cstdlib>
+
+static long long cellKey(int cellX, int cellY) {
+    return ((long long)cellX << 32) | (unsigned int)cellY;
+}
+
+static long long squaredDistance(int x1, int y1, int x2, int y2) {
+    long long dx = (long long)x1 - x2;
+    long long dy = (long long)y1 - y2;
+    return dx * dx + dy * dy;
+}
+
+SpatialGrid::SpatialGrid(int cellSize_in) : cellSize(cellSize_in > 0 ? cellSize_in : 1),
+    minCellX(INT_MAX), maxCellX(INT_MIN), minCellY(INT_MAX), maxCellY(INT_MIN) {}
+
+int SpatialGrid::cellOf(int coordinate) const {
+    return coordinate >= 0 ? coordinate / cellSize : -((-(long long)coordinate + cellSize - 1) / cellSize);
+}
+
+void SpatialGrid::insert(int id, int x, int y) {
+    int cellX = cellOf(x);
+    int cellY = cellOf(y);
+    long long cell = cellKey(cellX, cellY);
+
+    auto found = entries.find(id);
+    if (found != entries.end()) {
+        Entry& entry = found->second;
+        entry.x = x;
+        entry.y = y;
+        if (entry.cell == cell) return;   //같은 칸 안에서 움직이면 좌표만 바꿈
+        remove(id);
+    }
+
+    vector<int>& members = cells[cell];
+    entries[id] = { x, y, cell, (int)members.size() };
+    members.push_back(id);
+
+    minCellX = min(minCellX, cellX);
+    maxCellX = max(maxCellX, cellX);
+    minCellY = min(minCellY, cellY);
+    maxCellY = max(maxCellY, cellY);
+}
+
+bool SpatialGrid::remove(int id) {
+    auto found = entries.find(id);
+    if (found == entries.end()) return false;
+
+    auto cell = cells.find(found->second.cell);
+    vector<int>& members = cell->second;
+    int slot = found->second.slot;
+    members[slot] = members.back();
+    entries[members[slot]].slot = slot;
+    members.pop_back();
+    if (members.empty()) cells.erase(cell);
+
+    entries.erase(id);
+    return true;
+}
+
+bool SpatialGrid::contains(int id) const {
+    return entries.count(id) > 0;
+}
+
+void SpatialGrid::clear() {
+    cells.clear();
+    entries.clear();
+    minCellX = minCellY = INT_MAX;
+    maxCellX = maxCellY = INT_MIN;
+}
+
+void SpatialGrid::visitCell(int cellX, int cellY, const function<void(int)>& visit) const {
+    if (cellX < minCellX || cellX > maxCellX || cellY < minCellY || cellY > maxCellY) return;
+    auto cell = cells.find(cellKey(cellX, cellY));
+    if (cell == cells.end()) return;
+    for (int id : cell->second) visit(id);
+}
+
+vector<int> SpatialGrid::kNearest(int x, int y, int k, const function<bool(int)>& accept) const {
+    vector<int> result;
+    if (k <= 0 || entries.empty()) return result;
+
+    //질의 칸에서 체비쇼프 거리 r인 칸들을 고리 단위로 넓혀 가며 보고, (거리, id) 최대 힙에 k개를 유지.
+    //r번째 고리의 점은 질의 지점에서 (r - 1) * cellSize보다 멀기 때문에 k번째 거리가 그 이하면 멈춘다
+    int centerX = cellOf(x);
+    int centerY = cellOf(y);
+    int maxRing = max(max(centerX - minCellX, maxCellX - centerX), max(centerY - minCellY, maxCellY - centerY));
+    vector<pair<long long, int>> best;
+    auto visit = [&](int id) {
+        if (accept && !accept(id)) return;
+        const Entry& entry = entries.at(id);
+        pair<long long, int> candidate(squaredDistance(x, y, entry.x, entry.y), id);
+        if ((int)best.size() < k) {
+            best.push_back(candidate);
+            push_heap(best.begin(), best.end());
+        }
+        else if (candidate < best.front()) {
+            pop_heap(best.begin(), best.end());
+            best.back() = candidate;
+            push_heap(best.begin(), best.end());
+        }
+    };
+
+    //점이 듬성듬성하면 빈 칸만 계속 보게 되므로, 다음 고리의 칸 수가 점이 있는 칸 수보다 많아지면
+    //남은 고리는 점이 있는 칸만 직접 훑는다 (고리 r 이상인 칸)
+    for (int ring = 0; ring <= maxRing; ring++) {
+        if ((int)best.size() == k && ring >= 1) {
+            long long gap = (long long)(ring - 1) * cellSize;
+            if (gap * gap >= best.front().first) break;
+        }
+        if (8LL * ring > (long long)cells.size()) {
+            for (const auto& cell : cells) {
+                int cellX = (int)(cell.first >> 32);
+                int cellY = (int)(unsigned int)cell.first;
+                if (max(abs(cellX - centerX), abs(cellY - centerY)) < ring) continue;
+                for (int id : cell.second) visit(id);
+            }
+            break;
+        }
+        if (ring == 0) {
+            visitCell(centerX, centerY, visit);
+            continue;
+        }
+        for (int cellX = centerX - ring; cellX <= centerX + ring; cellX++) {   //위아래 변
+            visitCell(cellX, centerY - ring, visit);
+            visitCell(cellX, centerY + ring, visit);
+        }
+        for (int cellY = centerY - ring + 1; cellY <= centerY + ring - 1; cellY++) {   //좌우 변 (모서리 제외)
+            visitCell(centerX - ring, cellY, visit);
+            visitCell(centerX + ring, cellY, visit);
+        }
+    }
+
+    sort(best.begin(), best.end());
+    for (const pair<long long, int>& entry : best) result.push_back(entry.second);
+    return result;
+}
+
+vector<int> SpatialGrid::withinRadius(int x, int y, double radius, const function<bool(int)>& accept) const {
+    vector<int> result;
+    if (radius < 0 || entries.empty()) return result;
+
+    long long reach = (long long)ceil(radius);
+    int fromX = max(cellOf((int)max<long long>(INT_MIN, x - reach)), minCellX);
+    int toX = min(cellOf((int)min<long long>(INT_MAX, x + reach)), maxCellX);
+    int fromY = max(cellOf((int)max<long long>(INT_MIN, y - reach)), minCellY);
+    int toY = min(cellOf((int)min<long long>(INT_MAX, y + reach)), maxCellY);
+
+    vector<pair<long long, int>> found;
+    double limit = radius * radius;
+    auto visit = [&](int id) {
+        if (accept && !accept(id)) return;
+        const Entry& entry = entries.at(id);
+        long long distance = squaredDistance(x, y, entry.x, entry.y);
+        if (distance <= limit) found.push_back({ distance, id });
+    };
+    if (fromX <= toX && fromY <= toY && (long long)(toX - fromX + 1) * (toY - fromY + 1) > (long long)cells.size()) {
+        for (const auto& cell : cells) {   //범위의 칸이 점이 있는 칸보다 많으면 점이 있는 칸만 확인
+            int cellX = (int)(cell.first >> 32);
+            int cellY = (int)(unsigned int)cell.first;
+            if (cellX < fromX || cellX > toX || cellY < fromY || cellY > toY) continue;
+            for (int id : cell.second) visit(id);
+        }
+    }
+    else {
+        for (int cellX = fromX; cellX <= toX; cellX++) {
+            for (int cellY = fromY; cellY <= toY; cellY++) {
+                visitCell(cellX, cellY, visit);
+            }
+        }
+    }
+
+    sort(found.begin(), found.end());
+    for (const pair<long long, int>& entry : found) result.push_back(entry.second);
+    return result;
+}
+
+int SpatialGrid::size() const {
+    return entries.size();
+}
+
+int SpatialGrid::getCellSize() const {
+    return cellSize;
+}
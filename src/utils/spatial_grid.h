@@ -0,0 +1,51 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <vector>
+#include <unordered_map>
+#include <functional>
+
+using namespace std;
+
+// 좌표 위의 점들(기사, 주문 등 id로 구분)을 cellSize x cellSize 칸의 균일 격자에 나눠 담는 공간 색인.
+// 추가/이동/삭제는 O(1)이고, 가까운 k개와 반경 질의는 질의 지점 주변 칸만 본다. 빈 칸은 저장하지 않음
+class SpatialGrid {
+public:
+    explicit SpatialGrid(int cellSize = 16);
+
+    void insert(int id, int x, int y);   // 이미 있는 id면 그 위치로 이동
+    bool remove(int id);                 // 없는 id면 false
+    bool contains(int id) const;
+    void clear();
+
+    // (x, y)에서 가까운 순서로 최대 k개 id (거리가 같으면 id 순). accept가 있으면 accept(id)가 true인 점만
+    vector<int> kNearest(int x, int y, int k, const function<bool(int)>& accept = nullptr) const;
+    // (x, y)에서 radius 이내인 id, 가까운 순서
+    vector<int> withinRadius(int x, int y, double radius, const function<bool(int)>& accept = nullptr) const;
+
+    // Getters
+    int size() const;
+    int getCellSize() const;
+
+private:
+    struct Entry {
+        int x;
+        int y;
+        long long cell;
+        int slot;   // cells[cell] 안의 위치 (삭제할 때 맨 뒤 원소와 바꿔서 O(1))
+    };
+
+    int cellSize;
+    unordered_map<long long, vector<int>> cells;   // 칸 -> 그 칸의 id들
+    unordered_map<int, Entry> entries;
+    // 점이 들어온 적 있는 칸의 범위 (질의가 더 바깥 칸을 볼 필요가 없도록)
+    int minCellX;
+    int maxCellX;
+    int minCellY;
+    int maxCellY;
+
+    int cellOf(int coordinate) const;   // 음수 좌표도 아래로 내림
+    void visitCell(int cellX, int cellY, const function<void(int)>& visit) const;
+};
+
+#endif
@@ -0,0 +1,75 @@
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(int threadCount)
+    : currentTask(nullptr), taskCount(0), nextIndex(0), activeWorkers(0), generation(0), stopping(false) {
+    if (threadCount <= 0) threadCount = hardwareThreads();
+    for (int worker = 1; worker < threadCount; worker++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::hardwareThreads() {
+    int count = (int)thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
+
+void ThreadPool::parallelFor(int count, const function<void(int, int)>& task) {
+    if (count <= 0) return;
+    if (workers.empty() || count == 1) {   //스레드가 하나뿐이면 바로 실행
+        for (int index = 0; index < count; index++) {
+            task(0, index);
+        }
+        return;
+    }
+
+    {
+        lock_guard<mutex> guard(lock);
+        currentTask = &task;
+        taskCount = count;
+        nextIndex = 0;
+        activeWorkers = (int)workers.size();
+        generation++;
+    }
+    wake.notify_all();
+
+    runIndices(0);
+
+    unique_lock<mutex> guard(lock);
+    done.wait(guard, [this] { return activeWorkers == 0; });
+    currentTask = nullptr;
+}
+
+void ThreadPool::workerLoop(int worker) {
+    long long seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+
+        runIndices(worker);
+
+        lock_guard<mutex> guard(lock);
+        if (--activeWorkers == 0) done.notify_one();
+    }
+}
+
+void ThreadPool::runIndices(int worker) {
+    const function<void(int, int)>& task = *currentTask;
+    for (int index = nextIndex++; index < taskCount; index = nextIndex++) {
+        task(worker, index);
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+using namespace std;
+
+// 고정 개수의 작업 스레드를 유지하며 [0, count) 구간을 나눠 처리하는 스레드 풀.
+// 호출한 스레드도 worker 0으로 같이 일하고, 인덱스는 원자적 카운터로 하나씩 가져간다.
+// 각 인덱스의 결과가 서로 다른 곳에 기록되면 스레드 수와 관계없이 결과가 같다.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threadCount = 0);   // 0이면 하드웨어 스레드 수
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // task(worker, index)를 모든 index에 대해 실행하고 끝날 때까지 기다림. worker는 [0, getThreadCount())
+    void parallelFor(int count, const function<void(int, int)>& task);
+
+    int getThreadCount() const { return (int)workers.size() + 1; }
+    static int hardwareThreads();
+
+private:
+    vector<thread> workers;
+    mutex lock;
+    condition_variable wake;
+    condition_variable done;
+
+    const function<void(int, int)>* currentTask;
+    int taskCount;
+    atomic<int> nextIndex;
+    int activeWorkers;
+    long long generation;   // parallelFor 호출마다 증가, 작업 스레드가 새 일감을 알아보는 용도
+    bool stopping;
+
+    void workerLoop(int worker);
+    void runIndices(int worker);
+};
+
+#endif
@@ -0,0 +1,52 @@
+#include "travel_time_profile.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+TravelTimeProfile::TravelTimeProfile() : times{ 0 }, factors{ 1 }, period(86400), minFactor(1), maxDecline(0) {}
+
+TravelTimeProfile::TravelTimeProfile(const vector<pair<double, double>>& points, double period_in)
+    : period(period_in), minFactor(1), maxDecline(0) {
+    bool valid = !points.empty() && period > 0;
+    for (size_t k = 0; k < points.size() && valid; k++) {
+        if (points[k].first < 0 || points[k].first >= period || points[k].second <= 0) valid = false;
+        if (k > 0 && points[k].first <= points[k - 1].first) valid = false;
+    }
+    if (!valid) {
+        cerr << "Error: Travel time profile needs increasing times in [0, period) and positive factors; using a constant profile." << endl;
+        *this = TravelTimeProfile();
+        return;
+    }
+
+    for (const pair<double, double>& point : points) {
+        times.push_back((float)point.first);
+        factors.push_back((float)point.second);
+    }
+
+    minFactor = *min_element(factors.begin(), factors.end());
+    for (size_t k = 0; k < times.size(); k++) {   //주기 끝에서 처음으로 넘어가는 구간까지 포함
+        size_t next = (k + 1) % times.size();
+        double span = next > k ? times[next] - times[k] : times[next] + period - times[k];
+        maxDecline = max(maxDecline, (factors[k] - factors[next]) / span);
+    }
+}
+
+double TravelTimeProfile::factorAt(double time) const {
+    if (times.size() == 1) return factors[0];
+
+    double t = fmod(time, period);
+    if (t < 0) t += period;
+
+    //t 이하인 마지막 점 k와 그 다음 점 사이 선형 보간 (t가 첫 점보다 앞이면 이전 주기의 마지막 점에서 이어짐)
+    size_t upper = upper_bound(times.begin(), times.end(), (float)t) - times.begin();
+    size_t k = upper == 0 ? times.size() - 1 : upper - 1;
+    size_t next = (k + 1) % times.size();
+
+    double start = times[k];
+    double end = times[next];
+    if (upper == 0) start -= period;          //첫 점보다 앞: 이전 주기의 마지막 점부터
+    else if (next == 0) end += period;        //마지막 점 이후: 다음 주기의 첫 점까지
+
+    double ratio = (t - start) / (end - start);
+    return factors[k] + (factors[next] - factors[k]) * ratio;
+}
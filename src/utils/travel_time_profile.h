@@ -0,0 +1,34 @@
+#ifndef TRAVEL_TIME_PROFILE_H
+#define TRAVEL_TIME_PROFILE_H
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+using namespace std;
+
+// 시각에 따른 소요시간 배율 (출퇴근 정체 등). (시각, 배율) 점들을 구간 선형으로 잇고 period마다 반복한다.
+// 마지막 점과 다음 주기의 첫 점 사이도 선형으로 이어짐. 도로의 소요시간 = 기본 소요시간 * factorAt(출발 시각)
+// 점은 float로 저장하며 여러 도로가 한 프로필을 공유한다 (Map은 간선마다 프로필 번호만 가짐)
+class TravelTimeProfile {
+public:
+    TravelTimeProfile();   // 항상 1배
+    TravelTimeProfile(const vector<pair<double, double>>& points, double period = 86400);   // points: (주기 안의 시각, 배율 > 0), 시각 순
+
+    double factorAt(double time) const;
+    double getMinFactor() const { return minFactor; }
+    // 배율이 시간당 가장 빠르게 줄어드는 기울기 (양수). 소요시간 w인 도로는 w * maxDecline <= 1 이어야
+    // 늦게 출발한 차가 먼저 도착하지 않는다 (FIFO)
+    double getMaxDecline() const { return maxDecline; }
+    bool isFifoFor(double weight) const { return weight * maxDecline <= 1.0; }
+    size_t memoryBytes() const { return (times.size() + factors.size()) * sizeof(float); }
+
+private:
+    vector<float> times;
+    vector<float> factors;
+    double period;
+    double minFactor;
+    double maxDecline;
+};
+
+#endif